@@ -76,11 +76,8 @@ void Watchy7SEG::drawDate(){
     display.println(tmYearToCalendar(currentTime.Year));// offset from 1970, since year is stored in uint8_t
 }
 void Watchy7SEG::drawSteps(){
-    // reset step counter at midnight
-    if (currentTime.Hour == 0 && currentTime.Minute == 0){
-      sensor.resetStepCounter();
-    }
-    uint32_t stepCount = sensor.getCounter();
+    // steps since midnight, rolled over by the step log
+    uint32_t stepCount = stepLog.today();
     display.drawBitmap(10, 165, steps, 19, 23, DARKMODE ? GxEPD_WHITE : GxEPD_BLACK);
     display.setCursor(35, 190);
     display.println(stepCount);
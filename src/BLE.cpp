@@ -8,6 +8,19 @@
 #define CHARACTERISTIC_UUID_HW_VERSION "86b12867-4b70-4893-8ce6-9864fc00374d"
 #define CHARACTERISTIC_UUID_WATCHFACE_NAME                                     \
   "86b12868-4b70-4893-8ce6-9864fc00374d"
+#define CHARACTERISTIC_UUID_FW_FAST    "86b12869-4b70-4893-8ce6-9864fc00374d"
+
+// Task table sync. A cell record is 4 bytes: row, col, minutes (int16 LE).
+// Schema (read): numComponents, numTasks, then every component and task
+// name as length + bytes. Values (read/notify): read gives all cells as
+// int16 LE row by row, notifications carry batches of changed cell records.
+// Update (write, write without response): batches of cell records.
+#define SERVICE_UUID_TASKS             "86b12870-4b70-4893-8ce6-9864fc00374d"
+#define CHARACTERISTIC_UUID_SCHEMA     "86b12871-4b70-4893-8ce6-9864fc00374d"
+#define CHARACTERISTIC_UUID_VALUES     "86b12872-4b70-4893-8ce6-9864fc00374d"
+#define CHARACTERISTIC_UUID_UPDATE     "86b12873-4b70-4893-8ce6-9864fc00374d"
+#define TASK_RECORD                    4
+#define TASK_UPDATE_QUEUE              64
 
 #define FULL_PACKET         512
 #define CHARPOS_UPDATE_FLAG 5
@@ -16,6 +29,21 @@
 #define STATUS_DISCONNECTED 4
 #define STATUS_UPDATING     1
 #define STATUS_READY        2
+#define STATUS_ERROR        3
+
+// Fast OTA (CHARACTERISTIC_UUID_FW_FAST), write without response. Every write
+// starts with an opcode. START carries the manifest; the watch answers with
+// a credit holding the offset to continue from, 0 unless an interrupted
+// upload of the same image is on flash. The phone keeps at most OTA_WINDOW
+// data packets beyond the last credit; the flash writer task notifies
+// {OTA_CREDIT, bytes flashed (u32 LE)} every OTA_ACK_EVERY packets.
+#define OTA_START  0x01 // + image size (u32 LE) + SHA-256 (32)
+#define OTA_DATA   0x02 // + offset (u32 LE) + payload
+#define OTA_END    0x03
+#define OTA_CREDIT 0x10
+#define OTA_DONE   0x11 // + esp_err_t, ESP_ERR_INVALID_CRC on hash mismatch
+
+#define OTA_SECTOR 4096
 
 esp_ota_handle_t otaHandler = 0;
 
@@ -23,10 +51,184 @@ int status        = -1;
 int bytesReceived = 0;
 bool updateFlag   = false;
 
+static RingbufHandle_t otaRing               = NULL;
+static QueueHandle_t taskUpdates             = NULL;
+static uint16_t peerMtu                      = 23;
+static uint8_t valuesSnap[512]; // restored after each notify so reads see all cells
+static size_t valuesSnapLen                  = 0;
+static BLECharacteristic *otaFastCharacteristic = NULL;
+
+// Upload in progress, survives a disconnect or deep sleep so it can resume
+typedef struct otaSession {
+  uint8_t sha[32];
+  uint32_t size;
+  uint32_t offset; // bytes written to the update partition
+  bool active;
+} otaSession;
+
+RTC_DATA_ATTR otaSession upload = {};
+static mbedtls_sha256_context shaCtx;
+static uint32_t shaOffset = UINT32_MAX; // bytes in shaCtx, UINT32_MAX = none
+
+static uint32_t readU32(const uint8_t *p) {
+  return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void otaNotify(uint8_t op, uint32_t value) {
+  uint8_t txData[5] = {op, (uint8_t)value, (uint8_t)(value >> 8),
+                       (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+  otaFastCharacteristic->setValue(txData, 5);
+  otaFastCharacteristic->notify();
+}
+
+static esp_err_t otaStart(const esp_partition_t *part, const uint8_t *item,
+                          size_t len) {
+  if (len < 37) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  uint32_t size = readU32(item + 1);
+  if (size == 0 || size > part->size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  if (!upload.active || upload.size != size ||
+      memcmp(upload.sha, item + 5, 32) != 0) {
+    upload.size   = size;
+    upload.offset = 0;
+    upload.active = true;
+    memcpy(upload.sha, item + 5, 32);
+    shaOffset = UINT32_MAX;
+  }
+  if (shaOffset != upload.offset) {
+    // resumed after deep sleep: hash what is already on flash
+    mbedtls_sha256_init(&shaCtx);
+    mbedtls_sha256_starts(&shaCtx, 0);
+    uint8_t buf[512];
+    for (uint32_t at = 0; at < upload.offset; at += sizeof(buf)) {
+      size_t n = min((uint32_t)sizeof(buf), upload.offset - at);
+      if (esp_partition_read(part, at, buf, n) != ESP_OK) {
+        upload.offset = 0; // unreadable, start over
+        return otaStart(part, item, len);
+      }
+      mbedtls_sha256_update(&shaCtx, buf, n);
+    }
+    shaOffset = upload.offset;
+  }
+  return ESP_OK;
+}
+
+static esp_err_t otaData(const esp_partition_t *part, const uint8_t *data,
+                         size_t len) {
+  uint32_t offset = upload.offset;
+  if (offset + len > upload.size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  // erase the sectors this write is the first to touch
+  uint32_t from = (offset + OTA_SECTOR - 1) / OTA_SECTOR * OTA_SECTOR;
+  uint32_t to   = (offset + len + OTA_SECTOR - 1) / OTA_SECTOR * OTA_SECTOR;
+  esp_err_t err = ESP_OK;
+  if (to > from) {
+    err = esp_partition_erase_range(part, from, to - from);
+  }
+  if (err == ESP_OK) {
+    err = esp_partition_write(part, offset, data, len);
+  }
+  if (err == ESP_OK) {
+    mbedtls_sha256_update(&shaCtx, data, len);
+    upload.offset += len;
+    shaOffset = upload.offset;
+  }
+  return err;
+}
+
+static esp_err_t otaEnd(const esp_partition_t *part) {
+  if (upload.offset != upload.size) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  uint8_t sha[32];
+  mbedtls_sha256_finish(&shaCtx, sha);
+  mbedtls_sha256_free(&shaCtx);
+  shaOffset      = UINT32_MAX;
+  upload.active = false; // either done or corrupt, never resume from here
+  if (memcmp(sha, upload.sha, 32) != 0) {
+    return ESP_ERR_INVALID_CRC;
+  }
+  // verifies the image, then boots it pending confirmBoot() when the
+  // bootloader has rollback enabled
+  return esp_ota_set_boot_partition(part);
+}
+
+// Flash writer: erasing blocks for tens of ms, so it runs here and not in
+// the BLE callback, which only copies the write into otaRing
+static void otaWriterTask(void *pvParameters) {
+  const esp_partition_t *part = esp_ota_get_next_update_partition(NULL);
+  uint16_t packets            = 0;
+  for (;;) {
+    size_t len;
+    uint8_t *item = (uint8_t *)xRingbufferReceive(otaRing, &len, portMAX_DELAY);
+    if (item == NULL) {
+      continue;
+    }
+    esp_err_t err;
+    switch (item[0]) {
+    case OTA_START:
+      err        = otaStart(part, item, len);
+      updateFlag = true;
+      packets    = 0;
+      if (err == ESP_OK) {
+        status        = STATUS_UPDATING;
+        bytesReceived = upload.offset;
+        otaNotify(OTA_CREDIT, upload.offset); // opens the first window
+      } else {
+        status = STATUS_ERROR;
+        otaNotify(OTA_DONE, err);
+      }
+      break;
+    case OTA_DATA:
+      if (status != STATUS_UPDATING || len < 5) {
+        break;
+      }
+      if (readU32(item + 1) != upload.offset) {
+        // stale packet from before a reconnect, tell the phone where we are
+        otaNotify(OTA_CREDIT, upload.offset);
+        break;
+      }
+      err = otaData(part, item + 5, len - 5);
+      bytesReceived = upload.offset;
+      if (err != ESP_OK) {
+        status = STATUS_ERROR;
+        otaNotify(OTA_DONE, err);
+      } else if (++packets % OTA_ACK_EVERY == 0) {
+        otaNotify(OTA_CREDIT, upload.offset);
+      }
+      break;
+    case OTA_END:
+      if (status == STATUS_UPDATING) {
+        err    = otaEnd(part);
+        status = err == ESP_OK ? STATUS_READY : STATUS_ERROR;
+        otaNotify(OTA_DONE, err);
+      }
+      break;
+    }
+    vRingbufferReturnItem(otaRing, item);
+  }
+}
+
 class BLECustomServerCallbacks : public BLEServerCallbacks {
-  void onConnect(BLEServer *pServer) { status = STATUS_CONNECTED; };
+  void onConnect(BLEServer *pServer, esp_ble_gatts_cb_param_t *param) {
+    status = STATUS_CONNECTED;
+    // LE data length extension and the shortest connection interval
+    esp_ble_gap_set_pkt_data_len(param->connect.remote_bda, 251);
+    pServer->updateConnParams(param->connect.remote_bda, 6, 12, 0, 400);
+  };
 
-  void onDisconnect(BLEServer *pServer) { status = STATUS_DISCONNECTED; }
+  void onMtuChanged(BLEServer *pServer, esp_ble_gatts_cb_param_t *param) {
+    peerMtu = param->mtu.mtu;
+  }
+
+  void onDisconnect(BLEServer *pServer) {
+    status  = STATUS_DISCONNECTED;
+    peerMtu = 23;
+  }
 };
 
 class otaCallback : public BLECharacteristicCallbacks {
@@ -69,6 +271,31 @@ void otaCallback::onWrite(BLECharacteristic *pCharacteristic) {
   pCharacteristic->notify();
 }
 
+class otaFastCallback : public BLECharacteristicCallbacks {
+  void onWrite(BLECharacteristic *pCharacteristic) {
+    auto rxData = pCharacteristic->getValue();
+    if (rxData.length() == 0) {
+      return;
+    }
+    // never blocks: the window guarantees room unless the phone overruns it
+    if (xRingbufferSend(otaRing, rxData.c_str(), rxData.length(), 0) !=
+        pdTRUE) {
+      status = STATUS_ERROR;
+      otaNotify(OTA_DONE, ESP_ERR_NO_MEM);
+    }
+  }
+};
+
+class taskUpdateCallback : public BLECharacteristicCallbacks {
+  void onWrite(BLECharacteristic *pCharacteristic) {
+    auto rxData = pCharacteristic->getValue();
+    const uint8_t *p = (const uint8_t *)rxData.c_str();
+    for (size_t i = 0; i + TASK_RECORD <= rxData.length(); i += TASK_RECORD) {
+      xQueueSend(taskUpdates, p + i, 0); // full: the peer re-reads values
+    }
+  }
+};
+
 //
 // Constructor
 BLE::BLE(void) {}
@@ -82,6 +309,7 @@ BLE::~BLE(void) {}
 bool BLE::begin(const char *localName = "Watchy BLE OTA") {
   // Create the BLE Device
   BLEDevice::init(localName);
+  BLEDevice::setMTU(OTA_MTU);
 
   // Create the BLE Server
   pServer = BLEDevice::createServer();
@@ -108,6 +336,18 @@ bool BLE::begin(const char *localName = "Watchy BLE OTA") {
   pOtaCharacteristic->addDescriptor(new BLE2902());
   pOtaCharacteristic->setCallbacks(new otaCallback(this));
 
+  pOtaFastCharacteristic = pService->createCharacteristic(
+      CHARACTERISTIC_UUID_FW_FAST, BLECharacteristic::PROPERTY_NOTIFY |
+                                       BLECharacteristic::PROPERTY_WRITE_NR);
+  pOtaFastCharacteristic->addDescriptor(new BLE2902());
+  pOtaFastCharacteristic->setCallbacks(new otaFastCallback());
+  otaFastCharacteristic = pOtaFastCharacteristic;
+  if (otaRing == NULL) {
+    otaRing = xRingbufferCreate(OTA_RING_SIZE, RINGBUF_TYPE_NOSPLIT);
+    xTaskCreatePinnedToCore(otaWriterTask, "otaWriterTask", 4096, NULL, 2,
+                            NULL, 1);
+  }
+
   // Start the service(s)
   pESPOTAService->start();
   pService->start();
@@ -128,3 +368,70 @@ bool BLE::begin(const char *localName = "Watchy BLE OTA") {
 int BLE::updateStatus() { return status; }
 
 int BLE::howManyBytes() { return bytesReceived; }
+
+bool BLE::beginTaskSync(const char *localName) {
+  BLEDevice::init(localName);
+  BLEDevice::setMTU(OTA_MTU);
+
+  pServer = BLEDevice::createServer();
+  pServer->setCallbacks(new BLECustomServerCallbacks());
+
+  pTaskService          = pServer->createService(SERVICE_UUID_TASKS);
+  pSchemaCharacteristic = pTaskService->createCharacteristic(
+      CHARACTERISTIC_UUID_SCHEMA, BLECharacteristic::PROPERTY_READ);
+  pValuesCharacteristic = pTaskService->createCharacteristic(
+      CHARACTERISTIC_UUID_VALUES,
+      BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_NOTIFY);
+  pValuesCharacteristic->addDescriptor(new BLE2902());
+  pUpdateCharacteristic = pTaskService->createCharacteristic(
+      CHARACTERISTIC_UUID_UPDATE, BLECharacteristic::PROPERTY_WRITE |
+                                      BLECharacteristic::PROPERTY_WRITE_NR);
+  pUpdateCharacteristic->setCallbacks(new taskUpdateCallback());
+  if (taskUpdates == NULL) {
+    taskUpdates = xQueueCreate(TASK_UPDATE_QUEUE, TASK_RECORD);
+  }
+
+  pTaskService->start();
+  pServer->getAdvertising()->addServiceUUID(SERVICE_UUID_TASKS);
+  pServer->getAdvertising()->start();
+  return true;
+}
+
+void BLE::setTaskTable(const uint8_t *schema, size_t schemaLen,
+                       const uint8_t *values, size_t valuesLen) {
+  valuesSnapLen = min(valuesLen, sizeof(valuesSnap));
+  memcpy(valuesSnap, values, valuesSnapLen);
+  pSchemaCharacteristic->setValue((uint8_t *)schema, schemaLen);
+  pValuesCharacteristic->setValue(valuesSnap, valuesSnapLen);
+}
+
+void BLE::notifyCells(const uint8_t *records, size_t len) {
+  if (status != STATUS_CONNECTED) {
+    return;
+  }
+  size_t chunk = (peerMtu - 3) / TASK_RECORD * TASK_RECORD;
+  for (size_t i = 0; i < len; i += chunk) {
+    pValuesCharacteristic->setValue((uint8_t *)records + i, min(chunk, len - i));
+    pValuesCharacteristic->notify();
+  }
+  pValuesCharacteristic->setValue(valuesSnap, valuesSnapLen);
+}
+
+bool BLE::takeUpdate(uint8_t record[4]) {
+  return taskUpdates != NULL && xQueueReceive(taskUpdates, record, 0) == pdTRUE;
+}
+
+void BLE::end() {
+  BLEDevice::deinit(false);
+  status = -1;
+}
+
+void BLE::confirmBoot() {
+  // only does something when the bootloader was built with app rollback
+  esp_ota_img_states_t state;
+  if (esp_ota_get_state_partition(esp_ota_get_running_partition(), &state) ==
+          ESP_OK &&
+      state == ESP_OTA_IMG_PENDING_VERIFY) {
+    esp_ota_mark_app_valid_cancel_rollback();
+  }
+}
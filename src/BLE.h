@@ -9,6 +9,8 @@
 #include <BLEUtils.h>
 
 #include "esp_ota_ops.h"
+#include "freertos/ringbuf.h"
+#include "mbedtls/sha256.h"
 
 #include "config.h"
 
@@ -22,6 +24,15 @@ public:
   bool begin(const char *localName);
   int updateStatus();
   int howManyBytes();
+  static void confirmBoot(); // mark a freshly flashed image as good
+
+  // Task table service, binary encoded (see BLE.cpp)
+  bool beginTaskSync(const char *localName);
+  void setTaskTable(const uint8_t *schema, size_t schemaLen,
+                    const uint8_t *values, size_t valuesLen);
+  void notifyCells(const uint8_t *records, size_t len); // 4 byte records
+  bool takeUpdate(uint8_t record[4]); // next cell written by the peer
+  void end();
 
 private:
   String local_name;
@@ -34,7 +45,13 @@ private:
   BLEService *pService                            = NULL;
   BLECharacteristic *pVersionCharacteristic       = NULL;
   BLECharacteristic *pOtaCharacteristic           = NULL;
+  BLECharacteristic *pOtaFastCharacteristic       = NULL;
   BLECharacteristic *pWatchFaceNameCharacteristic = NULL;
+
+  BLEService *pTaskService                   = NULL;
+  BLECharacteristic *pSchemaCharacteristic   = NULL;
+  BLECharacteristic *pValuesCharacteristic   = NULL;
+  BLECharacteristic *pUpdateCharacteristic   = NULL;
 };
 
 #endif
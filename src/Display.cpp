@@ -412,6 +412,12 @@ void WatchyDisplay::_PowerOff()
 void WatchyDisplay::_InitDisplay()
 {
   if (_hibernating) _reset();
+  if (waitingPowerOn)
+  {
+    // asyncPowerOn() left the booster starting, the controller ignores commands until BUSY drops
+    waitingPowerOn = false;
+    _waitWhileBusy("_PowerOn", power_on_time);
+  }
 
   // No need to soft reset, the Display goes to same state after hard reset
   // _writeCommand(0x12); // soft reset
@@ -1,8 +1,10 @@
 #include "Watchy.h"
 
 #include <HTTPClient.h>
-#include <WebServer.h>      // za AP sync
+#include <esp_http_server.h> // za AP sync
 #include <WiFi.h>
+#include <esp_wifi.h>
+#include <ESPmDNS.h>
 #include <ArduinoJson.h> 
 #include "task_data_json.h" // sadrži json_task_data[]
 
@@ -16,8 +18,14 @@
 #endif
 GxEPD2_BW<WatchyDisplay, WatchyDisplay::HEIGHT> Watchy::display(
     WatchyDisplay{});
+WatchyScheduler Watchy::scheduler;
+WatchyOpLog Watchy::taskLog;
+WatchyStepLog Watchy::stepLog;
+HTTPClient netHttp;             // shared by the jobs of one Wi-Fi session
+static bool uploadTaskOps(HTTPClient &http, time_t now); // task server, next to fetchTaskData
+static void refreshTaskData(time_t now);
+unsigned long netSessionStart = 0;
 
-WebServer syncServer(8080);
 
 RTC_DATA_ATTR bool markerModeEnabled = false; // ako hoćeš default ON
 RTC_DATA_ATTR bool measuring = false;
@@ -41,7 +49,16 @@ RTC_DATA_ATTR bool USB_PLUGGED_IN = false;
 RTC_DATA_ATTR tmElements_t bootTime;
 RTC_DATA_ATTR uint32_t lastIPAddress;
 RTC_DATA_ATTR char lastSSID[30];
+RTC_DATA_ATTR uint8_t lastBSSID[6];
+RTC_DATA_ATTR uint8_t lastChannel = 0; // 0 = no cached AP, do a full scan
+RTC_DATA_ATTR uint32_t lastGateway;
+RTC_DATA_ATTR uint32_t lastSubnet;
+RTC_DATA_ATTR uint32_t lastDNS;
+RTC_DATA_ATTR uint32_t netRadioMs = 0; // Wi-Fi session time, reset daily
+RTC_DATA_ATTR uint8_t netRadioDay  = 0;
+RTC_DATA_ATTR uint16_t netSessions = 0;
 RTC_DATA_ATTR watchyAlarm myAlarm = {0, 0, 0, 0, 0, false};  // Initial values of Alarm
+RTC_DATA_ATTR bool watchStationary = false; // no-motion seen, ticks are skipped
 
 #define MAX_COMPONENTS 10
 #define MAX_TASKS 10
@@ -52,6 +69,11 @@ RTC_DATA_ATTR int taskValues[MAX_COMPONENTS][MAX_TASKS] = {0};
 RTC_DATA_ATTR int numComponents = 0;
 RTC_DATA_ATTR int numTasks = 0;
 RTC_DATA_ATTR bool hasCachedData = false; // da znamo da li uopšte postoji stara tabela
+RTC_DATA_ATTR char taskETag[48] = "";      // ETag keširane tabele (If-None-Match)
+RTC_DATA_ATTR uint32_t taskHash = 0;       // FNV-1a hash poslednjeg JSON-a
+RTC_DATA_ATTR uint32_t taskServerIP = 0;   // mDNS keš, 0 = nije razrešeno
+RTC_DATA_ATTR uint16_t taskServerPort = 0;
+RTC_DATA_ATTR time_t taskServerSeen = 0;   // RTC vreme poslednjeg razrešavanja
 
 RTC_DATA_ATTR int cursorRow = 0;
 RTC_DATA_ATTR int cursorCol = 0;
@@ -64,14 +86,68 @@ RTC_DATA_ATTR uint8_t partialCount = 0;      //morao sam da ubacim zbog namestan
 RTC_DATA_ATTR bool hiddenCol[MAX_TASKS] = {false};
 RTC_DATA_ATTR bool hiddenRow[MAX_COMPONENTS] = {false};
 
+static SemaphoreHandle_t tableMutex = NULL;
+
+// taskValues menjaju UI (merenje, fetch) i httpd task (/push)
+static void lockTable() {
+  if (tableMutex == NULL) {
+    tableMutex = xSemaphoreCreateMutex();
+  }
+  xSemaphoreTake(tableMutex, portMAX_DELAY);
+}
+
+static void unlockTable() { xSemaphoreGive(tableMutex); }
+
+// --- live izmene tabele za klijente sync AP-a (WebSocket /ws) ---
+static httpd_handle_t syncHttpd = NULL;
+static QueueHandle_t cellEvents = NULL;     // {r, c}, prazni ga httpd task
+static volatile bool wsResync = false;      // red je bio pun -> šalje se snapshot
+static volatile bool wsDrainQueued = false;
+static volatile uint8_t wsCount = 0;
+static volatile uint32_t otaHttpDone  = 0; // /ota progress, prikazuje ga AP petlja
+static volatile uint32_t otaHttpTotal = 0;
+static volatile int otaHttpResult     = -1; // esp_err_t kad se /ota završi
+static QueueHandle_t pushOps = NULL; // {r, c, delta int16 LE} sa /push, prazni ga AP petlja
+static int wsClients[SYNC_WS_CLIENTS];
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+static void wsDrain(void *arg);
+#endif
+
+// --- BLE task sync dok je Task Times otvoren ---
+#if TASK_BLE_SYNC
+static BLE bleSync;
+#endif
+static volatile bool bleSyncOn = false;
+static volatile bool bleDirty[MAX_COMPONENTS][MAX_TASKS]; // taskTimes ih šalje kao notify
+
+// poziva se posle svake izmene ćelije, iz bilo kog task-a
+static void publishCell(int r, int c) {
+  if (bleSyncOn) {
+    bleDirty[r][c] = true;
+  }
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+  if (syncHttpd == NULL || wsCount == 0) {
+    return;
+  }
+  uint8_t ev[2] = {(uint8_t)r, (uint8_t)c};
+  if (xQueueSend(cellEvents, ev, 0) != pdTRUE) {
+    wsResync = true; // spor klijent: umesto gomile događaja ide snapshot
+  }
+  if (!wsDrainQueued) {
+    wsDrainQueued = true;
+    httpd_queue_work(syncHttpd, wsDrain, NULL);
+  }
+#endif
+}
+
 
 void Watchy::init(String datetime) {
   esp_sleep_wakeup_cause_t wakeup_reason;
   wakeup_reason = esp_sleep_get_wakeup_cause(); // get wake up reason
   #ifdef ARDUINO_ESP32S3_DEV
-    Wire.begin(WATCHY_V3_SDA, WATCHY_V3_SCL);     // init i2c
+    Wire.begin(WATCHY_V3_SDA, WATCHY_V3_SCL, I2C_FREQ); // init i2c
   #else
-    Wire.begin(SDA, SCL);                         // init i2c
+    Wire.begin(SDA, SCL, I2C_FREQ);                     // init i2c
   #endif
   RTC.init();
   // Init the display since is almost sure we will use it
@@ -84,23 +160,14 @@ void Watchy::init(String datetime) {
   case ESP_SLEEP_WAKEUP_EXT0: // RTC Alarm
   #endif
     RTC.read(currentTime);
-    // Check alarm
-    if (myAlarm.active) {
-      int8_t currentYear = tmYearToY2k(currentTime.Year);
-      if (currentTime.Hour == myAlarm.hour && 
-        currentTime.Minute == myAlarm.minute && 
-        currentTime.Day == myAlarm.day && 
-        currentTime.Month == myAlarm.month &&
-        currentYear == myAlarm.year) {
-          // Start alarm
-          showAlarm();
-
-          myAlarm.active = false;
-      }
-    }
+    _logSteps();
+    _runDueJobs();
     switch (guiState) {
     case WATCHFACE_STATE:
-      showWatchFace(true); // partial updates on tick
+      // nobody is looking while stationary, redraw on the next motion wake
+      if (!_isStationary() && !settings.onDemandDisplay) {
+        showWatchFace(true); // partial updates on tick
+      }
       if (settings.vibrateOClock) {
         if (currentTime.Minute == 0) {
           // The RTC wakes us up once per minute
@@ -119,8 +186,15 @@ void Watchy::init(String datetime) {
       break;
     }
     break;
-  case ESP_SLEEP_WAKEUP_EXT1: // button Press
-    handleButtonPress();
+  case ESP_SLEEP_WAKEUP_EXT1: // button Press or accelerometer interrupt
+    if (esp_sleep_get_ext1_wakeup_status() & (BTN_PIN_MASK)) {
+      if (watchStationary) {
+        _setMotionDetect(false); // watch is in use, resume minute ticks
+      }
+      handleButtonPress();
+    } else {
+      _handleAccelWake();
+    }
     break;
   #ifdef ARDUINO_ESP32S3_DEV
   case ESP_SLEEP_WAKEUP_EXT0: // USB plug in
@@ -133,6 +207,11 @@ void Watchy::init(String datetime) {
     break;
   #endif
   default: // reset
+    if (settings.timezone != "") {
+      RTC.tz.setZone(settings.timezone.c_str());
+    } else {
+      RTC.tz.clearZone();
+    }
     RTC.config(datetime);
     _bmaConfig();
     #ifdef ARDUINO_ESP32S3_DEV
@@ -142,7 +221,19 @@ void Watchy::init(String datetime) {
     gmtOffset = settings.gmtOffset;
     RTC.read(currentTime);
     RTC.read(bootTime);
+    _logSteps();
+    if (NTP_SYNC_INTERVAL > 0) {
+      scheduler.add(JOB_NTP_SYNC, 0,
+                    makeTime(currentTime) + NTP_SYNC_INTERVAL * SECS_PER_MIN,
+                    NTP_SYNC_INTERVAL, NTP_SYNC_SLACK);
+    }
+    if (TASK_SYNC_INTERVAL > 0) {
+      scheduler.add(JOB_TASK_SYNC, 0,
+                    makeTime(currentTime) + TASK_SYNC_INTERVAL * SECS_PER_MIN,
+                    TASK_SYNC_INTERVAL, TASK_SYNC_SLACK);
+    }
     showWatchFace(false); // full update on reset
+    BLE::confirmBoot();   // RTC, display and sensor came up, keep this image
     vibMotor(75, 4);
     // For some reason, seems to be enabled on first boot
     esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
@@ -153,24 +244,26 @@ void Watchy::init(String datetime) {
 
 void Watchy::deepSleep() {
   display.hibernate();
-  RTC.clearAlarm();        // resets the alarm flag in the RTC
+  time_t nextWake = _nextWake();
+  // wrist raise wakes us in on-demand mode, any-motion while stationary
+  uint64_t accWakeMask =
+      (watchStationary || settings.onDemandDisplay) ? ACC_INT_MASK : 0;
+  RTC.clearAlarm(nextWake); // resets the alarm flag in the RTC
   #ifdef ARDUINO_ESP32S3_DEV
   esp_sleep_enable_ext0_wakeup((gpio_num_t)USB_DET_PIN, USB_PLUGGED_IN ? LOW : HIGH); //// enable deep sleep wake on USB plug in/out
   rtc_gpio_set_direction((gpio_num_t)USB_DET_PIN, RTC_GPIO_MODE_INPUT_ONLY);
   rtc_gpio_pullup_en((gpio_num_t)USB_DET_PIN);
 
   esp_sleep_enable_ext1_wakeup(
-      BTN_PIN_MASK,
+      BTN_PIN_MASK | accWakeMask,
       ESP_EXT1_WAKEUP_ANY_LOW); // enable deep sleep wake on button press
   rtc_gpio_set_direction((gpio_num_t)UP_BTN_PIN, RTC_GPIO_MODE_INPUT_ONLY);
   rtc_gpio_pullup_en((gpio_num_t)UP_BTN_PIN);
 
   rtc_clk_32k_enable(true);
   //rtc_clk_slow_freq_set(RTC_SLOW_FREQ_32K_XTAL);
-  struct tm timeinfo;
-  getLocalTime(&timeinfo);
-  int secToNextMin = 60 - timeinfo.tm_sec;
-  esp_sleep_enable_timer_wakeup(secToNextMin * uS_TO_S_FACTOR);
+  // drift compensated, sub-second exact
+  esp_sleep_enable_timer_wakeup(RTC.sleepMicros(nextWake));
   #else
   // Set GPIOs 0-39 to input to avoid power leaking out
   const uint64_t ignore = 0b11110001000000110000100111000010; // Ignore some GPIOs due to resets
@@ -182,12 +275,67 @@ void Watchy::deepSleep() {
   esp_sleep_enable_ext0_wakeup((gpio_num_t)RTC_INT_PIN,
                                0); // enable deep sleep wake on RTC interrupt
   esp_sleep_enable_ext1_wakeup(
-      BTN_PIN_MASK,
+      BTN_PIN_MASK | accWakeMask,
       ESP_EXT1_WAKEUP_ANY_HIGH); // enable deep sleep wake on button press
   #endif
   esp_deep_sleep_start();
 }
 
+static const char *menuItems[] = {
+    "About Watchy", "Vibrate Motor", "Show Accelerometer",
+    "Set Time",     "Setup WiFi",    "Update Firmware",
+    "Sync NTP",     "Set Alarm",    "Task Times"};
+static int8_t menuDrawn = -1; // označena stavka u bufferu, -1 = buffer nije meni
+
+// --- fast menu: tasteri preko prekida, CPU spava između pritisaka ---
+#define NO_BUTTON 0xFF
+static const uint8_t buttonPins[] = {MENU_BTN_PIN, BACK_BTN_PIN, UP_BTN_PIN,
+                                     DOWN_BTN_PIN};
+static QueueHandle_t buttonEvents = NULL;
+static volatile uint32_t lastButtonISR = 0;
+
+static void IRAM_ATTR buttonISR(void *arg) {
+  uint32_t now = millis();
+  if (now - lastButtonISR < BTN_DEBOUNCE_MS) {
+    return; // odskakanje kontakta
+  }
+  lastButtonISR = now;
+  uint8_t pin   = (uint32_t)arg;
+  BaseType_t woken = pdFALSE;
+  xQueueSendFromISR(buttonEvents, &pin, &woken);
+  if (woken) {
+    portYIELD_FROM_ISR();
+  }
+}
+
+// light sleep do pritiska ili isteka, vraća pin tastera ili NO_BUTTON
+static uint8_t sleepForButton(uint32_t ms) {
+  gpio_wakeup_disable((gpio_num_t)DISPLAY_BUSY); // ostaje posle busyCallback
+  for (uint8_t pin : buttonPins) {
+    // wakeup menja tip prekida u level, ISR bi inače okidao dok se drži
+    gpio_intr_disable((gpio_num_t)pin);
+    gpio_wakeup_enable((gpio_num_t)pin,
+                       ACTIVE_LOW ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+  }
+  esp_sleep_enable_gpio_wakeup();
+  esp_sleep_enable_timer_wakeup(ms * 1000ULL);
+  esp_light_sleep_start();
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+
+  uint8_t hit = NO_BUTTON;
+  for (uint8_t pin : buttonPins) {
+    if (hit == NO_BUTTON && digitalRead(pin) == ACTIVE_LOW) {
+      hit = pin;
+    }
+    gpio_wakeup_disable((gpio_num_t)pin);
+    gpio_set_intr_type((gpio_num_t)pin,
+                       ACTIVE_LOW ? GPIO_INTR_POSEDGE : GPIO_INTR_NEGEDGE);
+    gpio_intr_enable((gpio_num_t)pin);
+  }
+  lastButtonISR = millis(); // ivica koja nas je probudila je već u hit
+  return hit;
+}
+
 void Watchy::handleButtonPress() {
   uint64_t wakeupBit = esp_sleep_get_ext1_wakeup_status();
   // Menu Button
@@ -263,157 +411,180 @@ void Watchy::handleButtonPress() {
         menuIndex = 0;
       }
       showMenu(menuIndex, true);
+    } else if (guiState == FW_UPDATE_STATE) {
+      updateFWHttp();
     } else if (guiState == WATCHFACE_STATE) {
       return;
     }
   }
 
   /***************** fast menu *****************/
-  bool timeout     = false;
+  // CPU je u light sleep-u između pritisaka umesto da vrti digitalRead
+  if (buttonEvents == NULL) {
+    buttonEvents = xQueueCreate(8, sizeof(uint8_t));
+  }
+  xQueueReset(buttonEvents);
+  for (uint8_t pin : buttonPins) {
+    pinMode(pin, INPUT);
+    attachInterruptArg(pin, buttonISR, (void *)(uint32_t)pin,
+                       ACTIVE_LOW ? RISING : FALLING);
+  }
   long lastTimeout = millis();
-  pinMode(MENU_BTN_PIN, INPUT);
-  pinMode(BACK_BTN_PIN, INPUT);
-  pinMode(UP_BTN_PIN, INPUT);
-  pinMode(DOWN_BTN_PIN, INPUT);
-  while (!timeout) {
-    if (millis() - lastTimeout > 5000) {
-      timeout = true;
-    } else {
-      if (digitalRead(MENU_BTN_PIN) == ACTIVE_LOW) {
-        lastTimeout = millis();
-        if (guiState ==
-            MAIN_MENU_STATE) { // if already in menu, then select menu item
-          switch (menuIndex) {
-          case 0:
-            showAbout();
-            break;
-          case 1:
-            showBuzz();
-            break;
-          case 2:
-            showAccelerometer();
-            break;
-          case 3:
-            setTime();
-            break;
-          case 4:
-            setupWifi();
-            break;
-          case 5:
-            showUpdateFW();
-            break;
-          case 6:
-            showSyncNTP();
-            break;
-          case 7:
-            setAlarm();
-          case 8:
-            taskTimes();
-            break;
-          default:
-            break;
-          }
-        } else if (guiState == FW_UPDATE_STATE) {
-          updateFWBegin();
-        }
-      } else if (digitalRead(BACK_BTN_PIN) == ACTIVE_LOW) {
-        lastTimeout = millis();
-        if (guiState ==
-            MAIN_MENU_STATE) { // exit to watch face if already in menu
-          RTC.read(currentTime);
-          showWatchFace(false);
-          break; // leave loop
-        } else if (guiState == APP_STATE) {
-          showMenu(menuIndex, false); // exit to menu if already in app
-        } else if (guiState == FW_UPDATE_STATE) {
-          showMenu(menuIndex, false); // exit to menu if already in app
+  while (millis() - lastTimeout < FAST_MENU_TIMEOUT) {
+    uint8_t pin;
+    if (xQueueReceive(buttonEvents, &pin, 0) != pdTRUE) {
+      pin = sleepForButton(FAST_MENU_TIMEOUT - (millis() - lastTimeout));
+      if (pin == NO_BUTTON) {
+        continue; // isteklo
+      }
+    }
+    if (pin == MENU_BTN_PIN) {
+      lastTimeout = millis();
+      if (guiState ==
+          MAIN_MENU_STATE) { // if already in menu, then select menu item
+        menuDrawn = -1; // aplikacija crta preko menija
+        switch (menuIndex) {
+        case 0:
+          showAbout();
+          break;
+        case 1:
+          showBuzz();
+          break;
+        case 2:
+          showAccelerometer();
+          break;
+        case 3:
+          setTime();
+          break;
+        case 4:
+          setupWifi();
+          break;
+        case 5:
+          showUpdateFW();
+          break;
+        case 6:
+          showSyncNTP();
+          break;
+        case 7:
+          setAlarm();
+        case 8:
+          taskTimes();
+          break;
+        default:
+          break;
         }
-      } else if (digitalRead(UP_BTN_PIN) == ACTIVE_LOW) {
-        lastTimeout = millis();
-        if (guiState == MAIN_MENU_STATE) { // increment menu index
-          menuIndex--;
-          if (menuIndex < 0) {
-            menuIndex = MENU_LENGTH - 1;
-          }
-          showFastMenu(menuIndex);
+      } else if (guiState == FW_UPDATE_STATE) {
+        updateFWBegin();
+      }
+      xQueueReset(buttonEvents); // pritisci unutar aplikacije nisu za meni
+    } else if (pin == BACK_BTN_PIN) {
+      lastTimeout = millis();
+      if (guiState ==
+          MAIN_MENU_STATE) { // exit to watch face if already in menu
+        RTC.read(currentTime);
+        showWatchFace(false);
+        break; // leave loop
+      } else if (guiState == APP_STATE) {
+        showMenu(menuIndex, false); // exit to menu if already in app
+      } else if (guiState == FW_UPDATE_STATE) {
+        showMenu(menuIndex, false); // exit to menu if already in app
+      }
+    } else if (pin == UP_BTN_PIN) {
+      lastTimeout = millis();
+      if (guiState == MAIN_MENU_STATE) { // increment menu index
+        menuIndex--;
+        if (menuIndex < 0) {
+          menuIndex = MENU_LENGTH - 1;
         }
-      } else if (digitalRead(DOWN_BTN_PIN) == ACTIVE_LOW) {
-        lastTimeout = millis();
-        if (guiState == MAIN_MENU_STATE) { // decrement menu index
-          menuIndex++;
-          if (menuIndex > MENU_LENGTH - 1) {
-            menuIndex = 0;
-          }
-          showFastMenu(menuIndex);
+        showFastMenu(menuIndex);
+      }
+    } else if (pin == DOWN_BTN_PIN) {
+      lastTimeout = millis();
+      if (guiState == MAIN_MENU_STATE) { // decrement menu index
+        menuIndex++;
+        if (menuIndex > MENU_LENGTH - 1) {
+          menuIndex = 0;
         }
+        showFastMenu(menuIndex);
+      } else if (guiState == FW_UPDATE_STATE) {
+        updateFWHttp();
       }
     }
   }
+  for (uint8_t pin : buttonPins) {
+    detachInterrupt(pin);
+  }
 }
 
-void Watchy::showMenu(byte menuIndex, bool partialRefresh) {
-  display.setFullWindow();
-  display.fillScreen(GxEPD_BLACK);
-  display.setFont(&FreeMonoBold9pt7b);
-
+// crta stavke first..last redom kao pun prikaz (highlight prekriva deo prethodne)
+static void drawMenuItems(int first, int last, byte menuIndex) {
   int16_t x1, y1;
   uint16_t w, h;
   int16_t yPos;
-
-  const char *menuItems[] = {
-      "About Watchy", "Vibrate Motor", "Show Accelerometer",
-      "Set Time",     "Setup WiFi",    "Update Firmware",
-      "Sync NTP",     "Set Alarm",    "Task Times"};
-  for (int i = 0; i < MENU_LENGTH; i++) {
+  for (int i = max(first, 0); i <= min(last, MENU_LENGTH - 1); i++) {
     yPos = MENU_HEIGHT + (MENU_HEIGHT * i);
-    display.setCursor(0, yPos);
+    Watchy::display.setCursor(0, yPos);
     if (i == menuIndex) {
-      display.getTextBounds(menuItems[i], 0, yPos, &x1, &y1, &w, &h);
-      display.fillRect(x1 - 1, y1 - 10, 200, h + 15, GxEPD_WHITE);
-      display.setTextColor(GxEPD_BLACK);
-      display.println(menuItems[i]);
+      Watchy::display.getTextBounds(menuItems[i], 0, yPos, &x1, &y1, &w, &h);
+      Watchy::display.fillRect(x1 - 1, y1 - 10, 200, h + 15, GxEPD_WHITE);
+      Watchy::display.setTextColor(GxEPD_BLACK);
+      Watchy::display.println(menuItems[i]);
     } else {
-      display.setTextColor(GxEPD_WHITE);
-      display.println(menuItems[i]);
+      Watchy::display.setTextColor(GxEPD_WHITE);
+      Watchy::display.println(menuItems[i]);
     }
   }
+}
+
+void Watchy::showMenu(byte menuIndex, bool partialRefresh) {
+  display.setFullWindow();
+  display.fillScreen(GxEPD_BLACK);
+  display.setFont(&FreeMonoBold9pt7b);
+  drawMenuItems(0, MENU_LENGTH - 1, menuIndex);
 
   display.display(partialRefresh);
+  menuDrawn = menuIndex;
 
   guiState = MAIN_MENU_STATE;
   alreadyInMenu = false;
 }
 
 void Watchy::showFastMenu(byte menuIndex) {
-  display.setFullWindow();
-  display.fillScreen(GxEPD_BLACK);
-  display.setFont(&FreeMonoBold9pt7b);
-
-  int16_t x1, y1;
-  uint16_t w, h;
-  int16_t yPos;
-
-  const char *menuItems[] = {
-      "About Watchy", "Vibrate Motor", "Show Accelerometer",
-      "Set Time",     "Setup WiFi",    "Update Firmware",
-      "Sync NTP",     "Set Alarm",    "Task times"};
-  for (int i = 0; i < MENU_LENGTH; i++) {
-    yPos = MENU_HEIGHT + (MENU_HEIGHT * i);
-    display.setCursor(0, yPos);
-    if (i == menuIndex) {
-      display.getTextBounds(menuItems[i], 0, yPos, &x1, &y1, &w, &h);
-      display.fillRect(x1 - 1, y1 - 10, 200, h + 15, GxEPD_WHITE);
-      display.setTextColor(GxEPD_BLACK);
-      display.println(menuItems[i]);
-    } else {
-      display.setTextColor(GxEPD_WHITE);
-      display.println(menuItems[i]);
-    }
+  if (menuDrawn < 0 || guiState != MAIN_MENU_STATE) {
+    // buffer ne drži meni (posle wake-a ili druge aplikacije): ceo ekran
+    display.setFullWindow();
+    display.fillScreen(GxEPD_BLACK);
+    display.setFont(&FreeMonoBold9pt7b);
+    drawMenuItems(0, MENU_LENGTH - 1, menuIndex);
+    display.display(true);
+    menuDrawn = menuIndex;
+    guiState  = MAIN_MENU_STATE;
+    return;
+  }
+  if (menuDrawn == menuIndex) {
+    return;
   }
 
-  display.display(true);
+  // menjaju se samo trake stare i nove označene stavke
+  int k[2] = {menuDrawn, menuIndex};
+  int16_t top[2], h[2];
+  for (int b = 0; b < 2; b++) {
+    top[b] = max(MENU_HEIGHT * k[b] - 4, 0);
+    h[b]   = min(MENU_HEIGHT * k[b] + MENU_HEIGHT + 10, DISPLAY_HEIGHT) - top[b];
+    display.fillRect(0, top[b], DISPLAY_WIDTH, h[b], GxEPD_BLACK);
+  }
+  display.setFont(&FreeMonoBold9pt7b);
+  drawMenuItems(min(k[0], k[1]) - 1, max(k[0], k[1]) + 1, menuIndex);
 
-  guiState = MAIN_MENU_STATE;
+  if (abs(k[0] - k[1]) <= 1) { // susedne trake se preklapaju: jedan prozor
+    int16_t y0 = min(top[0], top[1]);
+    int16_t y1 = max(top[0] + h[0], top[1] + h[1]);
+    display.displayWindow(0, y0, DISPLAY_WIDTH, y1 - y0);
+  } else {
+    display.displayWindow(0, top[0], DISPLAY_WIDTH, h[0]);
+    display.displayWindow(0, top[1], DISPLAY_WIDTH, h[1]);
+  }
+  menuDrawn = menuIndex;
 }
 
 void Watchy::showAbout() {
@@ -807,6 +978,15 @@ void Watchy::setAlarm() {
   myAlarm.year = year;
   myAlarm.active = true;
 
+  tmElements_t at;
+  at.Second = 0;
+  at.Minute = minute;
+  at.Hour   = hour;
+  at.Day    = day;
+  at.Month  = month;
+  at.Year   = y2kYearToTm(year);
+  scheduler.add(JOB_ALARM, 0, makeTime(at));
+
   showMenu(menuIndex, false);
 }
 
@@ -830,6 +1010,116 @@ void Watchy::showAlarm() {
   }
 }
 
+void Watchy::startTimer(uint32_t seconds, uint8_t tag) {
+  RTC.read(currentTime);
+  scheduler.add(JOB_TIMER, tag, makeTime(currentTime) + seconds);
+}
+
+void Watchy::runJob(const watchyJob &job) {
+  switch (job.type) {
+  case JOB_ALARM:
+    if (job.tag == 0) {
+      myAlarm.active = false;
+    }
+    showAlarm();
+    break;
+  case JOB_TIMER:
+    showAlarm();
+    break;
+  // network jobs run inside a session opened by _runDueJobs()
+  case JOB_NTP_SYNC:
+    if (WiFi.status() == WL_CONNECTED) {
+      syncNTP();
+    }
+    break;
+  case JOB_TASK_SYNC:
+    if (WiFi.status() == WL_CONNECTED) {
+      // push first so the fetched table already contains local edits
+      if (uploadTaskOps(netHttp, makeTime(currentTime))) {
+        if (hasCachedData) {
+          refreshTaskData(makeTime(currentTime));
+        } else {
+          fetchTaskData();
+        }
+      }
+    }
+    break;
+  case JOB_TASK_PUSH:
+    if (!uploadTaskOps(netHttp, makeTime(currentTime))) {
+      _scheduleTaskPush(TASK_PUSH_RETRY);
+    }
+    break;
+  default: // JOB_WEATHER and custom jobs are left to the watchface
+    break;
+  }
+}
+
+bool Watchy::isNetJob(uint8_t type) {
+  return type == JOB_NTP_SYNC || type == JOB_WEATHER ||
+         type == JOB_TASK_SYNC || type == JOB_TASK_PUSH;
+}
+
+uint32_t Watchy::radioOnMs() { return netRadioMs; }
+
+void Watchy::_runDueJobs() {
+  // Run alarms, timers and periodic jobs that are due. The first due network
+  // job opens one Wi-Fi session and every network job within its slack joins
+  // it, so the radio comes up once instead of once per subsystem.
+  time_t now   = makeTime(currentTime);
+  bool session = false;
+  watchyJob job;
+  while (scheduler.popDue(now, job) ||
+         (session && scheduler.popEarly(now, job))) {
+    if (!session && isNetJob(job.type)) {
+      session = true;
+      _netBegin();
+    }
+    runJob(job);
+  }
+  if (session) {
+    _netEnd();
+  }
+}
+
+bool Watchy::_netBegin() {
+  if (netRadioDay != currentTime.Day) {
+    netRadioDay = currentTime.Day;
+    netRadioMs  = 0;
+    netSessions = 0;
+  }
+  netSessions++;
+  netSessionStart = millis();
+  netHttp.setReuse(true); // keep-alive between jobs hitting the same host
+  return connectWiFi();
+}
+
+void Watchy::_netEnd() {
+  netHttp.setReuse(false);
+  netHttp.end(); // closes a kept-alive connection
+  WiFi.mode(WIFI_OFF);
+  btStop();
+  netRadioMs += millis() - netSessionStart;
+  Serial.printf("Wi-Fi session %u: %lu ms, %lu ms today\n", netSessions,
+                millis() - netSessionStart, netRadioMs);
+}
+
+time_t Watchy::_nextWake() {
+  // The watchface and the menu timeout still run on minute ticks
+  if (guiState != WATCHFACE_STATE ||
+      (!watchStationary && !settings.onDemandDisplay)) {
+    return 0;
+  }
+  RTC.read(currentTime);
+  time_t now  = makeTime(currentTime);
+  time_t wake = now - now % (MAX_SLEEP_MIN * SECS_PER_MIN) +
+                MAX_SLEEP_MIN * SECS_PER_MIN;
+  time_t due  = scheduler.nextDue();
+  if (due != 0 && due < wake) {
+    wake = due;
+  }
+  return wake <= now ? 0 : wake;
+}
+
 // --- clamp helper ---
 static inline int clampi(int v, int lo, int hi) {
   if (v < lo) return lo;
@@ -840,97 +1130,292 @@ static inline int clampi(int v, int lo, int hi) {
 // --- delete funkcije (rade nad TVOJIM taskValues) ---
 void Watchy::deleteRow(int row) {
   row = clampi(row, 0, 2);
+  lockTable();
   for (int c = 0; c < numTasks; ++c) {
     taskValues[row][c] = 0;
+    publishCell(row, c);
   }
+  unlockTable();
+  taskLog.resetRow(row, _taskOpTime());
+  _scheduleTaskPush(TASK_PUSH_DELAY);
 }
 
 void Watchy::deleteCol(int col) {
   col = clampi(col, 0, max(0, numTasks - 1));
+  lockTable();
   for (int r = 0; r < 3; ++r) {
     taskValues[r][col] = 0;
+    publishCell(r, col);
   }
+  unlockTable();
+  taskLog.resetCol(col, _taskOpTime());
+  _scheduleTaskPush(TASK_PUSH_DELAY);
 }
 
-void Watchy::fetchTaskData() {
-  Serial.println("Pokrenuta fetchTaskData");
+uint32_t Watchy::_taskOpTime() {
+  RTC.read(currentTime);
+  return makeTime(currentTime);
+}
 
-  if (hasCachedData) {
-    Serial.println("Podaci su već učitani – preskačem fetch");
-    return;
+void Watchy::_scheduleTaskPush(uint16_t delayMin) {
+  // an edit must not push an already pending upload further out
+  watchyJob job;
+  if (!scheduler.find(JOB_TASK_PUSH, 0, job)) {
+    scheduler.add(JOB_TASK_PUSH, 0, _taskOpTime() + delayMin * SECS_PER_MIN,
+                  0, TASK_PUSH_SLACK);
+  }
+}
+
+static const char *expectedComponents[MAX_COMPONENTS] = {"Hrdwr", "Sftwr", "Frmwr"};
+static const char *expectedTasks[MAX_TASKS] = {"Task1", "Task2", "Task3", "Rbt"};
+
+// puni values iz JSON-a, imena komponenti/taskova su fiksna
+static void parseTaskDoc(DynamicJsonDocument &doc,
+                         int values[MAX_COMPONENTS][MAX_TASKS]) {
+  JsonObject root = doc.as<JsonObject>();
+  for (int i = 0; i < 3; i++) {
+    JsonObject tasks = root[expectedComponents[i]];
+    for (int j = 0; j < 4; j++) {
+      values[i][j] = tasks[expectedTasks[j]];
+    }
   }
+}
 
-  const char* expectedComponents[MAX_COMPONENTS] = {"Hrdwr", "Sftwr", "Frmwr"};
-  const char* expectedTasks[MAX_TASKS] = {"Task1", "Task2", "Task3", "Rbt"};
+// ETag/hash novog JSON-a, upisuje se u RTC tek kad se tabela zaista primeni
+static char pendingETag[48];
+static uint32_t pendingHash;
 
-  DynamicJsonDocument doc(2048);
-  bool success = false;
+static void commitTaskETag() {
+  strncpy(taskETag, pendingETag, sizeof(taskETag));
+  taskHash = pendingHash;
+}
 
-  Serial.print("WiFi status: ");
-  Serial.println(WiFi.status());
+static uint32_t fnv1a(const String &s) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < s.length(); i++) {
+    h = (h ^ (uint8_t)s[i]) * 16777619u;
+  }
+  return h;
+}
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("Povezan na Wi-Fi – pokušavam fetch sa servera...");
+// DNS-SD upit za _watchytask._tcp, upisuje adresu u RTC keš
+static bool resolveTaskServer(time_t now) {
+  if (!MDNS.begin("watchy")) {
+    return false;
+  }
+  bool found              = false;
+  mdns_result_t *results  = NULL;
+  if (mdns_query_ptr(TASK_MDNS_SERVICE, "_tcp", TASK_MDNS_TIMEOUT, 1, &results) == ESP_OK) {
+    for (mdns_result_t *r = results; r && !found; r = r->next) {
+      for (mdns_ip_addr_t *a = r->addr; a; a = a->next) {
+        if (a->addr.type == ESP_IPADDR_TYPE_V4) {
+          taskServerIP   = a->addr.u_addr.ip4.addr;
+          taskServerPort = r->port;
+          taskServerSeen = now;
+          found          = true;
+          break;
+        }
+      }
+    }
+  }
+  mdns_query_results_free(results);
+  MDNS.end();
+  Serial.printf("mDNS %s._tcp: %s\n", TASK_MDNS_SERVICE,
+                found ? IPAddress(taskServerIP).toString().c_str() : "nema odgovora");
+  return found;
+}
 
-    Serial.print("Watchy IP: ");
-    Serial.println(WiFi.localIP());
+static bool taskServerFresh(time_t now) {
+  return taskServerSeen != 0 &&
+         now - taskServerSeen <= (time_t)TASK_MDNS_TTL * SECS_PER_MIN;
+}
 
-    HTTPClient http;
-    http.begin("http://192.168.0.111:5000/data");
-    int httpCode = http.GET();
+// URL servera iz keša, upit ide samo kad je keš istekao ili je prethodna
+// konekcija pala (refresh)
+static String taskServerURL(time_t now, bool refresh) {
+  if (refresh || !taskServerFresh(now)) {
+    if (!resolveTaskServer(now)) {
+      taskServerIP   = 0; // negativan keš: do isteka TTL-a ide TASK_SERVER_HOST
+      taskServerSeen = now;
+    }
+  }
+  if (taskServerIP == 0) {
+    return String("http://") + TASK_SERVER_HOST + ":" + TASK_SERVER_PORT;
+  }
+  return "http://" + IPAddress(taskServerIP).toString() + ":" + taskServerPort;
+}
+
+// Šalje log izmena u jednom POST-u na /ops, ili celu tabelu ako je log
+// prepunjen. Na grešci log ostaje za sledeću sesiju.
+static bool uploadTaskOps(HTTPClient &http, time_t now) {
+  if (Watchy::taskLog.count() == 0 && !Watchy::taskLog.overflowed()) {
+    return true;
+  }
+  if (WiFi.status() != WL_CONNECTED) {
+    return false;
+  }
+  taskOp ops[MAX_OPS];
+  bool overflow;
+  uint8_t n = Watchy::taskLog.take(ops, overflow);
+
+  DynamicJsonDocument doc(4096);
+  if (overflow) {
+    JsonArray values = doc.createNestedArray("values");
+    lockTable();
+    for (int i = 0; i < numComponents; i++) {
+      JsonArray row = values.createNestedArray();
+      for (int j = 0; j < numTasks; j++) {
+        row.add(taskValues[i][j]);
+      }
+    }
+    unlockTable();
+  } else {
+    WatchyOpLog::toJson(ops, n, doc.createNestedArray("ops"));
+  }
+  String body;
+  serializeJson(doc, body);
+
+  http.setConnectTimeout(TASK_CONNECT_TIMEOUT);
+  http.begin(taskServerURL(now, false) + "/ops");
+  http.addHeader("Content-Type", "application/json");
+  int httpCode = http.POST(body);
+  http.end();
+  Serial.printf("Upload %u izmena%s: HTTP %d\n", n, overflow ? " (snapshot)" : "", httpCode);
+
+  if (httpCode != 200) {
+    Watchy::taskLog.restore(ops, n, overflow);
+    return false;
+  }
+  return true;
+}
 
-    Serial.print("HTTP status: ");
-    Serial.println(httpCode);
+#define DOWNLOAD_FAILED    -1
+#define DOWNLOAD_UNCHANGED 0
+#define DOWNLOAD_NEW       1
 
-    if (httpCode == 200) {
-      String payload = http.getString();
+// Uslovni HTTP GET sa servera, ne dira globalne podatke tabele. Na 304 ili
+// isti hash nema parsiranja ni redraw-a.
+static int8_t downloadTaskData(HTTPClient &http, int values[MAX_COMPONENTS][MAX_TASKS], time_t now) {
+  if (WiFi.status() != WL_CONNECTED) {
+    return DOWNLOAD_FAILED;
+  }
+  Serial.println("Povezan na Wi-Fi – pokušavam fetch sa servera...");
+  Serial.print("Watchy IP: ");
+  Serial.println(WiFi.localIP());
+
+  const char *headers[] = {"ETag"};
+  int8_t result    = DOWNLOAD_FAILED;
+  bool cached = numComponents > 0; // postoji tabela na koju se ETag odnosi
+  bool fromCache = taskServerFresh(now);
+  int httpCode = -1;
+  http.setConnectTimeout(TASK_CONNECT_TIMEOUT);
+  for (int attempt = 0; attempt < 2; attempt++) {
+    http.begin(taskServerURL(now, attempt == 1) + "/data");
+    http.collectHeaders(headers, 1);
+    if (cached && taskETag[0] != 0) {
+      http.addHeader("If-None-Match", taskETag);
+    }
+    httpCode = http.GET();
+    // keširana adresa ne odgovara -> jedan novi mDNS upit i ponovni pokušaj
+    if (httpCode >= 0 || !fromCache) {
+      break;
+    }
+    http.end();
+    fromCache = false;
+  }
+
+  Serial.print("HTTP status: ");
+  Serial.println(httpCode);
+
+  if (httpCode == HTTP_CODE_NOT_MODIFIED && cached) {
+    Serial.println("304 – tabela nije menjana");
+    result = DOWNLOAD_UNCHANGED;
+  } else if (httpCode == 200) {
+    String payload = http.getString();
+    strncpy(pendingETag, http.header("ETag").c_str(), sizeof(pendingETag) - 1);
+    pendingETag[sizeof(pendingETag) - 1] = 0;
+    pendingHash = fnv1a(payload);
+
+    if (cached && pendingHash == taskHash) {
+      Serial.println("Isti hash – preskačem parsiranje");
+      commitTaskETag(); // server bez ETag-a ili sa novim ETag-om za isti sadržaj
+      result = DOWNLOAD_UNCHANGED;
+    } else {
       Serial.println("Primljen JSON:");
       Serial.println(payload);
 
+      DynamicJsonDocument doc(2048);
       DeserializationError error = deserializeJson(doc, payload);
       if (error) {
         Serial.print("Greška pri parsiranju JSON sa Wi-Fi: ");
         Serial.println(error.c_str());
       } else {
-        success = true;
+        parseTaskDoc(doc, values);
+        result = DOWNLOAD_NEW;
         Serial.println("JSON uspešno parsiran sa Wi-Fi servera");
       }
-    } else {
-      Serial.println("HTTP odgovor nije 200 – problem u vezi/serveru");
     }
+  } else {
+    Serial.println("HTTP odgovor nije 200 – problem u vezi/serveru");
+  }
+  http.end();
+  return result;
+}
 
-    http.end();
-    delay(1000);
+// JOB_TASK_SYNC sa keširanom tabelom: download ide u pomoćnu tabelu, keš
+// i ETag se menjaju samo kad je stigla nova tabela. Neuspeo GET ne sme da
+// vrati statički JSON preko izmerenih vrednosti.
+static void refreshTaskData(time_t now) {
+  static int values[MAX_COMPONENTS][MAX_TASKS];
+  int8_t result = downloadTaskData(netHttp, values, now);
+  if (result == DOWNLOAD_NEW) {
+    lockTable();
+    memcpy(taskValues, values, sizeof(taskValues));
+    unlockTable();
+    commitTaskETag();
+  } else if (result == DOWNLOAD_FAILED) {
+    Serial.println("Sync fetch nije uspeo – ostaje keširana tabela");
+  }
+}
+
+void Watchy::fetchTaskData(bool online) {
+  Serial.println("Pokrenuta fetchTaskData");
+
+  if (hasCachedData) {
+    Serial.println("Podaci su već učitani – preskačem fetch");
+    return;
   }
 
+  Serial.print("WiFi status: ");
+  Serial.println(WiFi.status());
+
+  RTC.read(currentTime);
+  int8_t result = online ? downloadTaskData(netHttp, taskValues, makeTime(currentTime)) : DOWNLOAD_FAILED;
+  if (result == DOWNLOAD_NEW) {
+    commitTaskETag();
+  }
   // Ako nije uspeo Wi-Fi fetch, pokušaj iz statičkog JSON-a
-  if (!success) {
+  if (result == DOWNLOAD_FAILED) {
+    taskETag[0] = 0; // tabela više ne odgovara ETag-u sa servera
+    taskHash    = 0;
     Serial.println("Koristim statički JSON iz koda (fallback)");
 
+    DynamicJsonDocument doc(2048);
     DeserializationError error = deserializeJson(doc, json_task_data);
     if (error) {
       Serial.print("Greška pri parsiranju statičkog JSON-a: ");
       Serial.println(error.c_str());
       return;
     }
-
+    parseTaskDoc(doc, taskValues);
     Serial.println("Učitan statički JSON iz PROGMEM");
   }
 
-  // Učitaj podatke u taskValues iz `doc`
-
-  JsonObject root = doc.as<JsonObject>();
-
   for (int i = 0; i < 3; i++) {
     strncpy(componentNames[i], expectedComponents[i], sizeof(componentNames[i]));
-    JsonObject tasks = root[expectedComponents[i]];
-
-    for (int j = 0; j < 4; j++) {
-      if (i == 0) {
-        strncpy(taskNames[j], expectedTasks[j], sizeof(taskNames[j]));
-      }
-      taskValues[i][j] = tasks[expectedTasks[j]];
-    }
+  }
+  for (int j = 0; j < 4; j++) {
+    strncpy(taskNames[j], expectedTasks[j], sizeof(taskNames[j]));
   }
   numComponents = 3;
   numTasks = 4;
@@ -943,6 +1428,101 @@ void Watchy::fetchTaskData() {
   Serial.println(numTasks);
 }
 
+// --- pozadinski fetch za taskTimes: UI crta iz keša, task puni fetchedValues ---
+#define FETCH_IDLE    0
+#define FETCH_RUNNING 1
+#define FETCH_OK      2
+#define FETCH_FAILED  3
+
+static TaskHandle_t taskFetchHandle = NULL;
+static volatile uint8_t taskFetchState = FETCH_IDLE;
+static volatile bool taskFetchStop = false; // taskTimes izlazi ili pali AP
+static int fetchedValues[MAX_COMPONENTS][MAX_TASKS];
+
+static void taskFetchTask(void *pvParameters) {
+  Watchy *watchy = (Watchy *)pvParameters;
+  HTTPClient http; // netHttp pripada job sesiji na glavnom task-u
+  int8_t result  = DOWNLOAD_FAILED;
+  if (!taskFetchStop && watchy->connectWiFi() && !taskFetchStop) {
+    // lokalne izmene prvo na server, inače bi ih preuzeta tabela pregazila
+    if (uploadTaskOps(http, makeTime(watchy->currentTime)) && !taskFetchStop) {
+      result = downloadTaskData(http, fetchedValues, makeTime(watchy->currentTime));
+    }
+  }
+  WiFi.mode(WIFI_OFF); // tabela se dalje menja preko BLE/AP-a, radio nije potreban
+  switch (result) {
+  case DOWNLOAD_NEW:       taskFetchState = FETCH_OK; break;
+  case DOWNLOAD_UNCHANGED: taskFetchState = FETCH_IDLE; break;
+  default:                 taskFetchState = FETCH_FAILED; break;
+  }
+  taskFetchHandle = NULL;
+  vTaskDelete(NULL);
+}
+
+// zaustavlja pozadinski fetch i čeka da task izađe (HTTP pozivi imaju timeout)
+static void stopTaskFetch() {
+  taskFetchStop = true;
+  while (taskFetchHandle != NULL) {
+    delay(10);
+  }
+  taskFetchStop = false;
+}
+
+#if TASK_BLE_SYNC
+// schema: [nc][nt] pa imena kao [len][bajtovi]; values: int16 LE, red po red
+static void bleTaskSnapshot() {
+  uint8_t schema[2 + (MAX_COMPONENTS + MAX_TASKS) * (1 + sizeof(componentNames[0]))];
+  uint8_t values[MAX_COMPONENTS * MAX_TASKS * 2];
+  size_t n = 0, v = 0;
+  lockTable();
+  schema[n++] = numComponents;
+  schema[n++] = numTasks;
+  for (int i = 0; i < numComponents; ++i) {
+    uint8_t len = strnlen(componentNames[i], sizeof(componentNames[i]));
+    schema[n++] = len;
+    memcpy(schema + n, componentNames[i], len);
+    n += len;
+  }
+  for (int j = 0; j < numTasks; ++j) {
+    uint8_t len = strnlen(taskNames[j], sizeof(taskNames[j]));
+    schema[n++] = len;
+    memcpy(schema + n, taskNames[j], len);
+    n += len;
+  }
+  for (int i = 0; i < numComponents; ++i) {
+    for (int j = 0; j < numTasks; ++j) {
+      int16_t x = constrain(taskValues[i][j], INT16_MIN, INT16_MAX);
+      values[v++] = x & 0xFF;
+      values[v++] = (x >> 8) & 0xFF;
+    }
+  }
+  unlockTable();
+  bleSync.setTaskTable(schema, n, values, v);
+}
+
+// izmenjene ćelije idu kao notify zapisi [r][c][v int16 LE]
+static void bleTaskFlush() {
+  uint8_t records[MAX_COMPONENTS * MAX_TASKS * 4];
+  size_t n = 0;
+  lockTable();
+  for (int i = 0; i < numComponents; ++i) {
+    for (int j = 0; j < numTasks; ++j) {
+      if (!bleDirty[i][j]) continue;
+      bleDirty[i][j] = false;
+      int16_t x = constrain(taskValues[i][j], INT16_MIN, INT16_MAX);
+      records[n++] = i;
+      records[n++] = j;
+      records[n++] = x & 0xFF;
+      records[n++] = (x >> 8) & 0xFF;
+    }
+  }
+  unlockTable();
+  if (n == 0) return;
+  bleSync.notifyCells(records, n);
+  bleTaskSnapshot(); // read posle reconnect-a vidi novo stanje
+}
+#endif
+
 void Watchy::taskTimes() {
   Serial.begin(115200);
   Serial.println("taskTimes pokrenut!");
@@ -951,13 +1531,16 @@ void Watchy::taskTimes() {
   for (int i = 0; i < numComponents; ++i) hiddenRow[i] = false;
 
   // --- (WiFi/JSON tok) ---
-  if (WiFi.status() != WL_CONNECTED) {
-    WiFi.begin();
-    int tries = 0;
-    while (WiFi.status() != WL_CONNECTED && tries < 10) { delay(500); tries++; }
+  // crtaj odmah iz RTC keša (prvi put iz statičkog JSON-a), a server se
+  // čita u pozadini i kasnije se osvežavaju samo promenjene ćelije
+  if (!hasCachedData) {
+    fetchTaskData(false); // puni componentNames/taskNames/taskValues; numComponents=3; numTasks>=1
+  }
+  if (taskFetchHandle == NULL) {
+    RTC.read(currentTime); // za TTL mDNS keša
+    taskFetchState = FETCH_RUNNING;
+    xTaskCreatePinnedToCore(taskFetchTask, "taskFetchTask", 8192, (void*)this, 1, &taskFetchHandle, 0);
   }
-  hasCachedData = false;
-  fetchTaskData(); // puni componentNames/taskNames/taskValues; numComponents=3; numTasks>=1
 
   if (numComponents == 0 || numTasks == 0) {
     display.setFullWindow();
@@ -966,15 +1549,16 @@ void Watchy::taskTimes() {
     display.setCursor(10, 50);
     display.println("Nema podataka!");
     display.display(false);
+    stopTaskFetch();
     return;
   }
 
   // hard reset drawing state (sprečava "zoom"/isečeni prikaz iz prethodnog partial-a)
+  // bez posebnog refresh-a, drawFull() ionako radi full update
   display.setFullWindow();
   display.setTextSize(1);
   display.setRotation(0);
-  display.firstPage();
-  do { display.fillScreen(GxEPD_WHITE); } while (display.nextPage());
+  display.fillScreen(GxEPD_WHITE);
 
 
   // --- lokalni helperi (partial/full/indikator) ---
@@ -1171,6 +1755,65 @@ void Watchy::taskTimes() {
     if (cursorRow >= rcnt) cursorRow = max(0, rcnt-1);
   };
 
+  // upiši rezultat pozadinskog fetch-a, partial samo za vidljive promenjene ćelije
+  auto applyFetchedValues = [&]() {
+    auto [vcols, vcnt] = buildVisibleCols();
+    auto [vrows, rcnt] = buildVisibleRows();
+    int dirtyRow[VROWS * VCOLS], dirtyCol[VROWS * VCOLS];
+    int dirty = 0;
+    for (int r = 0; r < min(rcnt, VROWS); ++r) {
+      for (int c = 0; c < min(vcnt, VCOLS); ++c) {
+        int i = vrows[r], j = vcols[c];
+        if (measuring && i == measureRealRow && j == measureRealCol) continue; // lokalno merenje ima prednost
+        if (fetchedValues[i][j] == taskValues[i][j]) continue;
+        dirtyRow[dirty] = r;
+        dirtyCol[dirty] = c;
+        dirty++;
+      }
+    }
+    lockTable();
+    for (int i = 0; i < numComponents; ++i) {
+      for (int j = 0; j < numTasks; ++j) {
+        if (measuring && i == measureRealRow && j == measureRealCol) continue;
+        if (taskValues[i][j] == fetchedValues[i][j]) continue;
+        taskValues[i][j] = fetchedValues[i][j];
+        publishCell(i, j);
+      }
+    }
+    unlockTable();
+    if (dirty == 0) return;
+    if (dirty > 4 || partialCount + dirty >= 50) {
+      drawFull();
+      drawModeIndicator();
+      partialCount = 0;
+      return;
+    }
+    for (int k = 0; k < dirty; ++k) {
+      redrawCellPartial(dirtyRow[k], dirtyCol[k],
+                        dirtyRow[k] == cursorRow && dirtyCol[k] == cursorCol);
+    }
+    partialCount += dirty;
+  };
+
+  // telefon upisuje ćeliju preko BLE -> partial ako je vidljiva
+  auto redrawRealCell = [&](int i, int j) {
+    auto [vcols, vcnt] = buildVisibleCols();
+    auto [vrows, rcnt] = buildVisibleRows();
+    for (int r = 0; r < min(rcnt, VROWS); ++r) {
+      for (int c = 0; c < min(vcnt, VCOLS); ++c) {
+        if (vrows[r] != i || vcols[c] != j) continue;
+        if (partialCount >= 50) {
+          drawFull();
+          drawModeIndicator();
+          partialCount = 0;
+          return;
+        }
+        redrawCellPartial(r, c, r == cursorRow && c == cursorCol);
+        partialCount++;
+      }
+    }
+  };
+
   // --- init pinova i state ---
   guiState = APP_STATE;
   pinMode(BACK_BTN_PIN, INPUT);
@@ -1185,6 +1828,14 @@ void Watchy::taskTimes() {
   drawModeIndicator();
   partialCount = 0;
 
+#if TASK_BLE_SYNC
+  if (!bleSyncOn) {
+    bleSync.beginTaskSync(BLE_DEVICE_NAME);
+    bleSyncOn = true;
+  }
+  bleTaskSnapshot();
+#endif
+
   // edge detekcija tastera
   auto rd = [&](int pin){ return digitalRead(pin) == ACTIVE_LOW; };
   bool pUp=rd(UP_BTN_PIN), pDn=rd(DOWN_BTN_PIN), pMn=rd(MENU_BTN_PIN), pBk=rd(BACK_BTN_PIN);
@@ -1345,25 +1996,46 @@ void Watchy::taskTimes() {
 
       if (dur >= BACK_LONG_MS) {
         Serial.println("DEBUG: Detected BACK long-press -> starting Sync AP");
+        stopTaskFetch(); // AP preuzima Wi-Fi
+#if TASK_BLE_SYNC
+        // Bluedroid se gasi pre btStop() u startSyncAP, i notify petlja
+        // više ne dira BLE dok AP radi
+        bool bleWasOn = bleSyncOn;
+        if (bleSyncOn) {
+          bleSyncOn = false;
+          bleSync.end();
+        }
+#endif
         startSyncAP();
         display.setFullWindow();
         display.fillScreen(GxEPD_BLACK);
         display.setTextColor(GxEPD_WHITE);
         display.setCursor(0,20);
         display.println("Sync AP Started");
-        display.println("SSID: Watchy-AP-SYNC");
+        display.println("SSID: " SYNC_AP_SSID);
         display.println("Connect to 192.168.4.1:8080");
         display.display(false);
 
-        // keep server running until BACK pressed
+        // httpd radi u svom task-u, ovde se samo čeka BACK (i prati /ota)
+        otaHttpResult = -1;
+        uint32_t otaShown = 0;
         while (true) {
-          syncServer.handleClient();
+          measureTickIfNeeded();
+          _logSyncPush();
+          if (otaHttpTotal > 0 &&
+              (otaHttpDone - otaShown) * 100 >= otaHttpTotal * OTA_PROGRESS_STEP) {
+            otaShown = otaHttpDone;
+            _drawOTAProgress(otaShown, otaHttpTotal);
+          }
+          if (otaHttpResult == ESP_OK) {
+            _drawOTAProgress(otaHttpTotal, otaHttpTotal);
+            delay(500); // da stigne HTTP odgovor
+            esp_restart();
+          }
           if (digitalRead(BACK_BTN_PIN) == ACTIVE_LOW) {
             Serial.println("DEBUG: BACK pressed while in AP -> stopping AP");
             // stop AP and server
-            syncServer.stop();
-            WiFi.softAPdisconnect(true);
-            WiFi.mode(WIFI_OFF);
+            stopSyncAP();
             display.setFullWindow();
             display.fillScreen(GxEPD_WHITE);
             display.display(false);
@@ -1372,6 +2044,14 @@ void Watchy::taskTimes() {
           delay(50);
         }
 
+#if TASK_BLE_SYNC
+        if (bleWasOn) {
+          bleSync.beginTaskSync(BLE_DEVICE_NAME);
+          bleSyncOn = true;
+          bleTaskSnapshot(); // telefon nije video izmene sa /push
+        }
+#endif
+
         // reset prev button states to current hardware state after AP mode
         pUp = digitalRead(UP_BTN_PIN) == ACTIVE_LOW;
         pDn = digitalRead(DOWN_BTN_PIN) == ACTIVE_LOW;
@@ -1383,6 +2063,12 @@ void Watchy::taskTimes() {
       } else {
         // kratko otpuštanje -> interpretiraj kao normalan "back" (exit u meni)
         Serial.println("DEBUG: Detected BACK short-press -> exit to menu");
+#if TASK_BLE_SYNC
+        if (bleSyncOn) {
+          bleSyncOn = false;
+          bleSync.end();
+        }
+#endif
         guiState = MAIN_MENU_STATE;
         display.setFullWindow();
         display.fillScreen(GxEPD_WHITE);
@@ -1441,147 +2127,394 @@ void Watchy::taskTimes() {
       measureUpdated = false;
     }
 
-    // 7) final housekeeping: update previous state and short delay
+    // 7) pozadinski fetch završen -> patch promenjenih ćelija
+    if (taskFetchState == FETCH_OK) {
+      applyFetchedValues();
+      commitTaskETag();
+      taskFetchState = FETCH_IDLE;
+    } else if (taskFetchState == FETCH_FAILED) {
+      Serial.println("Pozadinski fetch nije uspeo – ostaje keširana tabela");
+      taskFetchState = FETCH_IDLE;
+    }
+
+#if TASK_BLE_SYNC
+    // 8) BLE: upisi sa telefona, pa notify za sve izmenjene ćelije
+    if (bleSyncOn) {
+      uint8_t rec[4];
+      while (bleSync.takeUpdate(rec)) {
+        int i = rec[0], j = rec[1];
+        if (i >= numComponents || j >= numTasks) continue;
+        if (measuring && i == measureRealRow && j == measureRealCol) continue; // lokalno merenje ima prednost
+        lockTable();
+        int delta = (int16_t)(rec[2] | (rec[3] << 8)) - taskValues[i][j];
+        taskValues[i][j] += delta;
+        unlockTable();
+        if (delta == 0) continue;
+        publishCell(i, j);
+        taskLog.add(i, j, delta, _taskOpTime()); // server dobija izmenu kao i za merenje
+        _scheduleTaskPush(TASK_PUSH_DELAY);
+        redrawRealCell(i, j);
+      }
+      bleTaskFlush();
+    }
+#endif
+
+    // 9) final housekeeping: update previous state and short delay
     pUp = up; pDn = dn; pMn = mn; pBk = bk;
     delay(60);
   } // end for(;;)
+  stopTaskFetch();
 
 }
 
 
-// --- helper task for syncServer handling (top-level, place near globals) ---
-static TaskHandle_t syncServerTaskHandle = NULL;
-static WebServer* gSyncServerPtr = nullptr;
+// --- sync AP: native soft-AP + esp_http_server koji radi u svom task-u ---
+static esp_err_t sendJson(httpd_req_t *req, const char *status, const char *body) {
+  httpd_resp_set_status(req, status);
+  httpd_resp_set_type(req, "application/json");
+  return httpd_resp_sendstr(req, body);
+}
 
-static void syncServerTask(void *pvParameters) {
-  WebServer *srv = (WebServer*)pvParameters;
-  if (!srv) vTaskDelete(NULL);
-  for (;;) {
-    srv->handleClient();
-    vTaskDelay(pdMS_TO_TICKS(40)); // 25Hz poll
+// cela tabela kao JSON, za /state i prvi /ws frame
+static String tableJson() {
+  // snapshot pod lock-om, serijalizacija bez njega
+  int values[MAX_COMPONENTS][MAX_TASKS];
+  lockTable();
+  int nc = numComponents, nt = numTasks;
+  memcpy(values, taskValues, sizeof(values));
+  unlockTable();
+
+  DynamicJsonDocument doc(4096);
+  doc["numComponents"] = nc;
+  doc["numTasks"] = nt;
+  JsonArray comps = doc.createNestedArray("componentNames");
+  for(int i=0;i<nc;i++) comps.add(componentNames[i]);
+  JsonArray tasks = doc.createNestedArray("taskNames");
+  for(int j=0;j<nt;j++) tasks.add(taskNames[j]);
+  JsonArray rows = doc.createNestedArray("values");
+  for(int i=0;i<nc;i++){
+    JsonArray row = rows.createNestedArray();
+    for(int j=0;j<nt;j++){
+      row.add(values[i][j]);
+    }
   }
+  String out; serializeJson(doc, out);
+  return out;
 }
 
-// --- new startSyncAP() using WiFiManager + background server task ---
-void Watchy::startSyncAP(){
-  const char* apSSID = "Watchy-AP-SYNC";
-  const char* apPwd  = ""; // možeš probati "" ili "watchypass"
+static esp_err_t syncStateHandler(httpd_req_t *req) {
+  return sendJson(req, HTTPD_200, tableJson().c_str());
+}
 
-  Serial.println("DEBUG: startSyncAP() - using WiFiManager AP (workaround)");
+// POST /ota: telo zahteva ide direktno u esp_ota_write, bez slike u RAM-u
+// X-Image-SHA256: 64 hex znaka -> 32 bajta
+static bool parseSha256(const char *hex, uint8_t sha[32]) {
+  if (strlen(hex) != 64) {
+    return false;
+  }
+  for (int i = 0; i < 64; i++) {
+    if (!isxdigit((unsigned char)hex[i])) {
+      return false;
+    }
+  }
+  for (int i = 0; i < 32; i++) {
+    char byte[3] = {hex[2 * i], hex[2 * i + 1], 0};
+    sha[i] = strtoul(byte, NULL, 16);
+  }
+  return true;
+}
 
-  // Stop Bluetooth (can interfere)
-  btStop();
+// poređenje tokena bez ranog izlaska, vreme ne otkriva prefiks
+static bool tokenMatches(const char *got, const char *want) {
+  size_t n = strlen(want);
+  if (strlen(got) != n) {
+    return false;
+  }
+  uint8_t diff = 0;
+  for (size_t i = 0; i < n; i++) {
+    diff |= got[i] ^ want[i];
+  }
+  return diff == 0;
+}
 
-  // Prepare syncServer endpoints (register handlers) BEFORE server.begin
-  syncServer.on("/state", HTTP_GET, [](){
-    StaticJsonDocument<10240> doc;
-    doc["numComponents"] = numComponents;
-    doc["numTasks"] = numTasks;
-    JsonArray comps = doc.createNestedArray("componentNames");
-    for(int i=0;i<numComponents;i++) comps.add(String(componentNames[i]));
-    JsonArray tasks = doc.createNestedArray("taskNames");
-    for(int j=0;j<numTasks;j++) tasks.add(String(taskNames[j]));
-    JsonArray values = doc.createNestedArray("values");
-    for(int i=0;i<numComponents;i++){
-      JsonArray row = values.createNestedArray();
-      for(int j=0;j<numTasks;j++){
-        row.add(taskValues[i][j]);
-      }
-    }
-    String out; serializeJson(doc, out);
-    syncServer.send(200, "application/json", out);
-  });
+static esp_err_t syncOtaHandler(httpd_req_t *req) {
+  static char buf[OTA_HTTP_CHUNK]; // samo httpd task
+  char hdr[72];
+  // na otvorenom AP-u bilo ko u dometu bi mogao da flešuje sat
+  if (strlen(SYNC_AP_PASS) < 8 || SYNC_OTA_TOKEN[0] == 0) {
+    return sendJson(req, "403 Forbidden", "{\"error\":\"ota disabled\"}");
+  }
+  if (httpd_req_get_hdr_value_str(req, "X-OTA-Token", hdr, sizeof(hdr)) != ESP_OK ||
+      !tokenMatches(hdr, SYNC_OTA_TOKEN)) {
+    return sendJson(req, "403 Forbidden", "{\"error\":\"bad token\"}");
+  }
+  uint8_t want[32];
+  if (httpd_req_get_hdr_value_str(req, "X-Image-SHA256", hdr, sizeof(hdr)) != ESP_OK ||
+      !parseSha256(hdr, want)) {
+    return sendJson(req, HTTPD_400, "{\"error\":\"no sha256\"}");
+  }
+  const esp_partition_t *part = esp_ota_get_next_update_partition(NULL);
+  if (req->content_len == 0 || req->content_len > part->size) {
+    return sendJson(req, HTTPD_400, "{\"error\":\"bad size\"}");
+  }
+  esp_ota_handle_t ota;
+  mbedtls_sha256_context sha;
+  mbedtls_sha256_init(&sha);
+  mbedtls_sha256_starts(&sha, 0);
+  esp_err_t err     = esp_ota_begin(part, req->content_len, &ota);
+  otaHttpTotal      = req->content_len;
+  otaHttpDone       = 0;
+  unsigned long t0  = millis();
+  int timeouts      = 0; // klijent koji je stao ne sme zauvek da drži httpd task
+  while (err == ESP_OK && otaHttpDone < otaHttpTotal) {
+    int n = httpd_req_recv(req, buf, min((size_t)sizeof(buf), (size_t)(otaHttpTotal - otaHttpDone)));
+    if (n == HTTPD_SOCK_ERR_TIMEOUT && ++timeouts < SYNC_RECV_TIMEOUTS) continue;
+    timeouts = 0;
+    if (n <= 0) {
+      // klijent je otišao ili stao: nema kome da se odgovori, httpd zatvara socket
+      esp_ota_abort(ota);
+      mbedtls_sha256_free(&sha);
+      Serial.printf("HTTP OTA: prekinuto posle %u B\n", otaHttpDone);
+      otaHttpResult = ESP_FAIL;
+      return ESP_FAIL;
+    }
+    mbedtls_sha256_update(&sha, (const uint8_t *)buf, n);
+    err = esp_ota_write(ota, buf, n);
+    otaHttpDone += n;
+  }
+  if (err == ESP_OK) {
+    err = esp_ota_end(ota);
+  } else {
+    esp_ota_abort(ota);
+  }
+  uint8_t got[32];
+  mbedtls_sha256_finish(&sha, got);
+  mbedtls_sha256_free(&sha);
+  if (err == ESP_OK && memcmp(got, want, 32) != 0) {
+    err = ESP_ERR_INVALID_CRC; // slika se ne aktivira
+  }
+  if (err == ESP_OK) {
+    err = esp_ota_set_boot_partition(part);
+  }
+  unsigned long ms = max(1UL, millis() - t0);
+  Serial.printf("HTTP OTA: %u B in %lu ms, %lu KB/s, err %d\n", otaHttpDone, ms,
+                otaHttpDone / ms, err);
+  otaHttpResult = err;
+  if (err != ESP_OK) {
+    return sendJson(req, HTTPD_500, "{\"error\":\"ota failed\"}");
+  }
+  return sendJson(req, HTTPD_200, "{\"status\":\"ok\"}");
+}
 
-  syncServer.on("/push", HTTP_POST, [](){
-    if(!syncServer.hasArg("plain")){
-      syncServer.send(400, "application/json", "{\"error\":\"no payload\"}");
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+static void wsRemove(int fd) {
+  for (uint8_t i = 0; i < wsCount; i++) {
+    if (wsClients[i] == fd) {
+      wsClients[i] = wsClients[--wsCount];
       return;
     }
-    String body = syncServer.arg("plain");
-    StaticJsonDocument<8192> doc;
-    DeserializationError err = deserializeJson(doc, body);
-    if(err){
-      syncServer.send(400, "application/json", "{\"error\":\"bad json\"}");
-      return;
+  }
+}
+
+static esp_err_t wsSend(int fd, const String &msg) {
+  httpd_ws_frame_t frame = {};
+  frame.type    = HTTPD_WS_TYPE_TEXT;
+  frame.payload = (uint8_t *)msg.c_str();
+  frame.len     = msg.length();
+  return httpd_ws_send_frame_async(syncHttpd, fd, &frame);
+}
+
+// httpd task: svi događaji iz reda u jedan frame {"cells":[[r,c,v],...]}
+static void wsDrain(void *arg) {
+  wsDrainQueued = false;
+  String msg;
+  uint8_t ev[2];
+  if (wsResync) {
+    wsResync = false;
+    while (xQueueReceive(cellEvents, ev, 0) == pdTRUE) {}
+    msg = tableJson();
+  } else {
+    bool seen[MAX_COMPONENTS][MAX_TASKS] = {};
+    int n = 0;
+    msg = "{\"cells\":[";
+    lockTable();
+    while (xQueueReceive(cellEvents, ev, 0) == pdTRUE) {
+      if (ev[0] >= MAX_COMPONENTS || ev[1] >= MAX_TASKS || seen[ev[0]][ev[1]]) continue;
+      seen[ev[0]][ev[1]] = true;
+      if (n++) msg += ',';
+      msg += "[" + String(ev[0]) + "," + String(ev[1]) + "," + String(taskValues[ev[0]][ev[1]]) + "]";
+    }
+    unlockTable();
+    if (n == 0) return;
+    msg += "]}";
+  }
+  for (int i = wsCount - 1; i >= 0; i--) {
+    int fd = wsClients[i];
+    if (httpd_ws_get_fd_info(syncHttpd, fd) != HTTPD_WS_CLIENT_WEBSOCKET ||
+        wsSend(fd, msg) != ESP_OK) {
+      wsRemove(fd); // klijent koji ne prima u send_wait_timeout se izbacuje
+      httpd_sess_trigger_close(syncHttpd, fd);
     }
-    if(!doc.containsKey("updates")){
-      syncServer.send(400, "application/json", "{\"error\":\"no updates\"}");
-      return;
+  }
+}
+
+static esp_err_t syncWsHandler(httpd_req_t *req) {
+  if (req->method == HTTP_GET) {
+    // handshake gotov: snapshot, pa dalje samo izmene
+    if (wsCount >= SYNC_WS_CLIENTS) {
+      return ESP_FAIL;
     }
-    JsonArray arr = doc["updates"].as<JsonArray>();
-    for(JsonVariant v : arr){
-      int r = v["r"] | -1;
-      int c = v["c"] | -1;
-      int val = v["v"] | 0;
-      if(r>=0 && r < MAX_COMPONENTS && c>=0 && c < MAX_TASKS){
-        taskValues[r][c] = val;
-      }
+    int fd = httpd_req_to_sockfd(req);
+    wsClients[wsCount++] = fd;
+    return wsSend(fd, tableJson());
+  }
+  // od klijenta se ništa ne očekuje, frame se samo pročita
+  uint8_t buf[128];
+  httpd_ws_frame_t frame = {};
+  esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+  if (err != ESP_OK || frame.len > sizeof(buf)) {
+    return ESP_FAIL;
+  }
+  frame.payload = buf;
+  return httpd_ws_recv_frame(req, &frame, frame.len);
+}
+
+static void syncSessionClosed(httpd_handle_t hd, int fd) {
+  wsRemove(fd);
+  close(fd);
+}
+#endif
+
+static esp_err_t syncPushHandler(httpd_req_t *req) {
+  if (req->content_len == 0 || req->content_len > 2048) {
+    return sendJson(req, HTTPD_400, "{\"error\":\"no payload\"}");
+  }
+  char body[2049];
+  size_t got   = 0;
+  int timeouts = 0;
+  while (got < req->content_len) {
+    int n = httpd_req_recv(req, body + got, req->content_len - got);
+    if (n == HTTPD_SOCK_ERR_TIMEOUT && ++timeouts < SYNC_RECV_TIMEOUTS) continue;
+    timeouts = 0;
+    if (n <= 0) return ESP_FAIL;
+    got += n;
+  }
+  body[got] = 0;
+
+  DynamicJsonDocument doc(4096);
+  DeserializationError err = deserializeJson(doc, body);
+  if(err){
+    return sendJson(req, HTTPD_400, "{\"error\":\"bad json\"}");
+  }
+  if(!doc.containsKey("updates")){
+    return sendJson(req, HTTPD_400, "{\"error\":\"no updates\"}");
+  }
+  JsonArray arr = doc["updates"].as<JsonArray>();
+  // svaka izmena mora u log za server, pa ceo zahtev ili ništa
+  if (uxQueueSpacesAvailable(pushOps) < arr.size()) {
+    return sendJson(req, "503 Service Unavailable", "{\"error\":\"busy\"}");
+  }
+  lockTable();
+  for(JsonVariant v : arr){
+    int r = v["r"] | -1;
+    int c = v["c"] | -1;
+    int val = v["v"] | 0;
+    if(r>=0 && r < MAX_COMPONENTS && c>=0 && c < MAX_TASKS){
+      int16_t delta = constrain(val - taskValues[r][c], INT16_MIN, INT16_MAX);
+      if (delta == 0) continue;
+      taskValues[r][c] += delta;
+      publishCell(r, c);
+      uint8_t op[4] = {(uint8_t)r, (uint8_t)c, (uint8_t)(delta & 0xFF),
+                       (uint8_t)((delta >> 8) & 0xFF)};
+      xQueueSend(pushOps, op, 0);
     }
-    // odgovori ok
-    syncServer.send(200, "application/json", "{\"status\":\"ok\"}");
-  });
+  }
+  unlockTable();
+  // odgovori ok
+  return sendJson(req, HTTPD_200, "{\"status\":\"ok\"}");
+}
 
-  // Start server object (it doesn't require AP up yet)
-  syncServer.begin();
-  gSyncServerPtr = &syncServer;
+void Watchy::startSyncAP(){
+  unsigned long startMs = millis();
+  uint32_t heapBefore   = ESP.getFreeHeap();
+
+  // Stop Bluetooth (can interfere)
+  btStop();
 
-  // create server handling task (runs independently)
-  if (syncServerTaskHandle == NULL) {
-    xTaskCreatePinnedToCore(syncServerTask, "syncServerTask", 4096, (void*)gSyncServerPtr, 1, &syncServerTaskHandle, 1);
-    Serial.println("DEBUG: syncServerTask created");
+  WiFi.mode(WIFI_AP); // Arduino sloj podiže netif i DHCP server
+  wifi_config_t conf = {};
+  strncpy((char *)conf.ap.ssid, SYNC_AP_SSID, sizeof(conf.ap.ssid));
+  conf.ap.ssid_len        = strlen(SYNC_AP_SSID);
+  conf.ap.channel         = SYNC_AP_CHANNEL;
+  conf.ap.max_connection  = SYNC_AP_MAX_CONN;
+  conf.ap.beacon_interval = SYNC_AP_BEACON;
+  if (strlen(SYNC_AP_PASS) >= 8) {
+    strncpy((char *)conf.ap.password, SYNC_AP_PASS, sizeof(conf.ap.password));
+    conf.ap.authmode = WIFI_AUTH_WPA2_PSK;
+  } else {
+    conf.ap.authmode = WIFI_AUTH_OPEN;
+  }
+  esp_wifi_set_config(WIFI_IF_AP, &conf);
+  esp_wifi_set_max_tx_power(SYNC_AP_TX_POWER); // korisnik je na par metara
+
+  if (syncHttpd == NULL) {
+    // jedan httpd task je jedini vlasnik servera, select() bez pollinga,
+    // više klijenata istovremeno
+    httpd_config_t config   = HTTPD_DEFAULT_CONFIG();
+    config.server_port      = 8080;
+    config.stack_size       = 8192; // JSON dokumenti
+    config.max_open_sockets = 4;
+    config.lru_purge_enable = true;
+    config.send_wait_timeout = 1; // s, spor klijent ne blokira ostale
+    #ifdef CONFIG_HTTPD_WS_SUPPORT
+    config.close_fn = syncSessionClosed;
+    if (cellEvents == NULL) {
+      cellEvents = xQueueCreate(SYNC_WS_QUEUE, 2);
+    }
+    #endif
+    if (pushOps == NULL) {
+      pushOps = xQueueCreate(MAX_OPS, 4);
+    }
+    if (httpd_start(&syncHttpd, &config) == ESP_OK) {
+      httpd_uri_t state = {"/state", HTTP_GET, syncStateHandler, NULL};
+      httpd_uri_t push  = {"/push", HTTP_POST, syncPushHandler, NULL};
+      httpd_register_uri_handler(syncHttpd, &state);
+      httpd_register_uri_handler(syncHttpd, &push);
+      httpd_uri_t ota   = {"/ota", HTTP_POST, syncOtaHandler, NULL};
+      httpd_register_uri_handler(syncHttpd, &ota);
+      #ifdef CONFIG_HTTPD_WS_SUPPORT
+      httpd_uri_t ws  = {};
+      ws.uri          = "/ws";
+      ws.method       = HTTP_GET;
+      ws.handler      = syncWsHandler;
+      ws.is_websocket = true;
+      httpd_register_uri_handler(syncHttpd, &ws);
+      #endif
+    }
   }
 
-  // Now start WiFiManager portal — this will create a visible AP like in setupWifi()
-  WiFiManager wifiManager;
-  wifiManager.setTimeout(0); // 0 -> keep portal until user connects / cancels (no auto timeout)
-
-  // [ADDED] omogućimo neblokirajući portal i pripremimo BACK pin
-  wifiManager.setConfigPortalBlocking(false);       // [ADDED]
-  pinMode(BACK_BTN_PIN, INPUT_PULLUP);              // [ADDED]
-
-  Serial.print("DEBUG: starting WiFiManager startConfigPortal with SSID: ");
-  Serial.println(apSSID);
-
-  // Note: startConfigPortal will block here while portal is active (AP visible)
-  bool ok = wifiManager.startConfigPortal(apSSID, apPwd);
-  Serial.printf("DEBUG: startConfigPortal returned=%d\n", ok ? 1 : 0);
-
-  // [ADDED] drži portal aktivnim i izađi kada je BACK pritisnut
-  while (wifiManager.getConfigPortalActive()) {     // [ADDED]
-    wifiManager.process();                          // [ADDED]
-    if (digitalRead(BACK_BTN_PIN) == ACTIVE_LOW) {  // [ADDED]
-      delay(25);                                    // [ADDED] debounce
-      if (digitalRead(BACK_BTN_PIN) == ACTIVE_LOW){ // [ADDED]
-        wifiManager.stopConfigPortal();             // [ADDED]
-        break;                                      // [ADDED]
-      }                                             // [ADDED]
-    }                                               // [ADDED]
-    delay(30);                                      // [ADDED]
-  }                                                 // [ADDED]
-
-  // At this point portal ended (user may have configured WiFi) -> we should stop server & AP
-  Serial.println("DEBUG: Exiting Sync AP mode - cleaning up");
-
-  // stop background task
-  if (syncServerTaskHandle != NULL) {
-    vTaskDelete(syncServerTaskHandle);
-    syncServerTaskHandle = NULL;
-    Serial.println("DEBUG: syncServerTask deleted");
-  }
-
-  // stop server
-  syncServer.stop();
-  gSyncServerPtr = nullptr;
-
-  // switch WiFi off or to STA depending on need
+  Serial.printf("Sync AP %s ready in %lu ms, heap used %d B\n", SYNC_AP_SSID,
+                millis() - startMs, (int)(heapBefore - ESP.getFreeHeap()));
+}
+
+void Watchy::stopSyncAP(){
+  if (syncHttpd != NULL) {
+    httpd_stop(syncHttpd);
+    syncHttpd = NULL;
+    wsCount   = 0;
+  }
   WiFi.softAPdisconnect(true);
   WiFi.mode(WIFI_OFF);
+  _logSyncPush(); // ono što je stiglo pre gašenja
+}
 
-  // clear display and return
-  display.setFullWindow();
-  display.fillScreen(GxEPD_WHITE);
-  display.display(false);
-  delay(200);
+// izmene sa /push idu u log i zakazuju upload, kao BLE upisi i merenje
+void Watchy::_logSyncPush() {
+  uint8_t op[4];
+  while (pushOps != NULL && xQueueReceive(pushOps, op, 0) == pdTRUE) {
+    taskLog.add(op[0], op[1], (int16_t)(op[2] | (op[3] << 8)), _taskOpTime());
+    _scheduleTaskPush(TASK_PUSH_DELAY);
+  }
 }
 
 
@@ -1600,7 +2533,12 @@ void Watchy::measureTickIfNeeded(){
     lastSentMinutes = minutes;
     // apply delta to real cell if valid
     if(measureRealRow >= 0 && measureRealRow < MAX_COMPONENTS && measureRealCol >= 0 && measureRealCol < MAX_TASKS){
+      lockTable();
       taskValues[measureRealRow][measureRealCol] += delta;
+      unlockTable();
+      publishCell(measureRealRow, measureRealCol);
+      taskLog.add(measureRealRow, measureRealCol, delta, _taskOpTime());
+      _scheduleTaskPush(TASK_PUSH_DELAY);
       // signal to taskTimes loop da je došlo do promene i treba partial redraw
       measureUpdated = true;
       // debug
@@ -1617,73 +2555,104 @@ void Watchy::showAccelerometer() {
   display.setFont(&FreeMonoBold9pt7b);
   display.setTextColor(GxEPD_WHITE);
 
-  Accel acc;
-
-  long previousMillis = 0;
-  long interval       = 200;
+  static Accel batch[ACCEL_FIFO_WATERMARK * 2];
 
   guiState = APP_STATE;
 
   pinMode(BACK_BTN_PIN, INPUT);
 
-  while (1) {
+  // senzor puni FIFO, CPU spava dok watermark ili BACK ne podigne pin
+  sensor.enableFIFO(ACCEL_FIFO_WATERMARK, ACCEL_FIFO_DOWN);
+  sensor.enableFIFOInterrupt();
+  sensor.getINT();
+  gpio_wakeup_disable((gpio_num_t)DISPLAY_BUSY); // ostaje posle busyCallback
+  gpio_wakeup_enable((gpio_num_t)BACK_BTN_PIN,
+                     ACTIVE_LOW ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+  #ifdef ARDUINO_ESP32S3_DEV
+  gpio_wakeup_enable((gpio_num_t)ACC_INT_1_PIN, GPIO_INTR_LOW_LEVEL);
+  #else
+  gpio_wakeup_enable((gpio_num_t)ACC_INT_1_PIN, GPIO_INTR_HIGH_LEVEL);
+  #endif
 
-    unsigned long currentMillis = millis();
+  while (1) {
+    esp_sleep_enable_gpio_wakeup();
+    esp_light_sleep_start();
 
     if (digitalRead(BACK_BTN_PIN) == ACTIVE_LOW) {
       break;
     }
+    // latch: čitanje statusa spušta INT1, i za step/tilt događaje
+    if (!sensor.getINT() || !sensor.isFIFOWatermark()) {
+      continue;
+    }
 
-    if (currentMillis - previousMillis > interval) {
-      previousMillis = currentMillis;
-      // Get acceleration data
-      bool res          = sensor.getAccel(acc);
-      uint8_t direction = sensor.getDirection();
-      display.fillScreen(GxEPD_BLACK);
-      display.setCursor(0, 30);
-      if (res == false) {
-        display.println("getAccel FAIL");
-      } else {
-        display.print("  X:");
-        display.println(acc.x);
-        display.print("  Y:");
-        display.println(acc.y);
-        display.print("  Z:");
-        display.println(acc.z);
-
-        display.setCursor(30, 130);
-        switch (direction) {
-        case DIRECTION_DISP_DOWN:
-          display.println("FACE DOWN");
-          break;
-        case DIRECTION_DISP_UP:
-          display.println("FACE UP");
-          break;
-        case DIRECTION_BOTTOM_EDGE:
-          display.println("BOTTOM EDGE");
-          break;
-        case DIRECTION_TOP_EDGE:
-          display.println("TOP EDGE");
-          break;
-        case DIRECTION_RIGHT_EDGE:
-          display.println("RIGHT EDGE");
-          break;
-        case DIRECTION_LEFT_EDGE:
-          display.println("LEFT EDGE");
-          break;
-        default:
-          display.println("ERROR!!!");
-          break;
-        }
-      }
-      display.display(true); // full refresh
+    // ceo batch u par I2C burst-ova, pa srednja vrednost (low-pass)
+    uint16_t n = sensor.readFIFO(batch, ACCEL_FIFO_WATERMARK * 2);
+    if (n == 0) {
+      continue;
+    }
+    int32_t sx = 0, sy = 0, sz = 0;
+    for (uint16_t i = 0; i < n; i++) {
+      sx += batch[i].x;
+      sy += batch[i].y;
+      sz += batch[i].z;
+    }
+    Accel acc;
+    acc.x = sx / n;
+    acc.y = sy / n;
+    acc.z = sz / n;
+    uint8_t direction = sensor.getDirection(acc);
+
+    display.fillScreen(GxEPD_BLACK);
+    display.setCursor(0, 30);
+    display.print("  X:");
+    display.println(acc.x);
+    display.print("  Y:");
+    display.println(acc.y);
+    display.print("  Z:");
+    display.println(acc.z);
+    display.print("  n:");
+    display.println(n);
+
+    display.setCursor(30, 130);
+    switch (direction) {
+    case DIRECTION_DISP_DOWN:
+      display.println("FACE DOWN");
+      break;
+    case DIRECTION_DISP_UP:
+      display.println("FACE UP");
+      break;
+    case DIRECTION_BOTTOM_EDGE:
+      display.println("BOTTOM EDGE");
+      break;
+    case DIRECTION_TOP_EDGE:
+      display.println("TOP EDGE");
+      break;
+    case DIRECTION_RIGHT_EDGE:
+      display.println("RIGHT EDGE");
+      break;
+    case DIRECTION_LEFT_EDGE:
+      display.println("LEFT EDGE");
+      break;
+    default:
+      display.println("ERROR!!!");
+      break;
     }
+    display.display(true); // partial refresh
+    gpio_wakeup_disable((gpio_num_t)DISPLAY_BUSY); // busyCallback ga opet uključi
   }
 
+  gpio_wakeup_disable((gpio_num_t)BACK_BTN_PIN);
+  gpio_wakeup_disable((gpio_num_t)ACC_INT_1_PIN);
+  sensor.enableFIFOInterrupt(false);
+  sensor.disableFIFO();
+  sensor.getINT();
+
   showMenu(menuIndex, false);
 }
 
 void Watchy::showWatchFace(bool partialRefresh) {
+  menuDrawn = -1;
   display.setFullWindow();
   // At this point it is sure we are going to update
   display.epd2.asyncPowerOn();
@@ -1812,30 +2781,13 @@ uint8_t Watchy::getBoardRevision() {
   return -1;
 }
 
-uint16_t Watchy::_readRegister(uint8_t address, uint8_t reg, uint8_t *data,
-                               uint16_t len) {
-  Wire.beginTransmission(address);
-  Wire.write(reg);
-  Wire.endTransmission();
-  Wire.requestFrom((uint8_t)address, (uint8_t)len);
-  uint8_t i = 0;
-  while (Wire.available()) {
-    data[i++] = Wire.read();
-  }
-  return 0;
-}
-
-uint16_t Watchy::_writeRegister(uint8_t address, uint8_t reg, uint8_t *data,
-                                uint16_t len) {
-  Wire.beginTransmission(address);
-  Wire.write(reg);
-  Wire.write(data, len);
-  return (0 != Wire.endTransmission());
-}
-
 void Watchy::_bmaConfig() {
+  // BMA423 preživi reset ESP32 (OTA, panic): bez ponovnog upload-a config-a
+  if (sensor.resume(bmaBusRead, bmaBusWrite, delay, BMA_SETUP_VERSION)) {
+    return;
+  }
 
-  if (sensor.begin(_readRegister, _writeRegister, delay) == false) {
+  if (sensor.begin(bmaBusRead, bmaBusWrite, delay) == false) {
     // fail to init BMA
     return;
   }
@@ -1895,12 +2847,18 @@ void Watchy::_bmaConfig() {
 
   struct bma4_int_pin_config config;
   config.edge_ctrl = BMA4_LEVEL_TRIGGER;
+  #ifdef ARDUINO_ESP32S3_DEV
+  config.lvl       = BMA4_ACTIVE_LOW; // ext1 shares ANY_LOW with the buttons
+  #else
   config.lvl       = BMA4_ACTIVE_HIGH;
+  #endif
   config.od        = BMA4_PUSH_PULL;
   config.output_en = BMA4_OUTPUT_ENABLE;
   config.input_en  = BMA4_INPUT_DISABLE;
   // The correct trigger interrupt needs to be configured as needed
   sensor.setINTPinConfig(config, BMA4_INTR1_MAP);
+  // Hold INT1 until the status is read so a short event can still wake us
+  sensor.setInterruptLatch(true);
 
   struct bma423_axes_remap remap_data;
   remap_data.x_axis      = 1;
@@ -1918,6 +2876,8 @@ void Watchy::_bmaConfig() {
   sensor.enableFeature(BMA423_TILT, true);
   // Enable BMA423 isDoubleClick feature
   sensor.enableFeature(BMA423_WAKEUP, true);
+  // Activity state (still / walking / running) for the step history
+  sensor.enableFeature(BMA423_ACTIVITY, true);
 
   // Reset steps
   sensor.resetStepCounter();
@@ -1927,6 +2887,58 @@ void Watchy::_bmaConfig() {
   sensor.enableTiltInterrupt();
   // It corresponds to isDoubleClick interrupt
   sensor.enableWakeupInterrupt();
+
+  // Start watching for the watch being put down
+  sensor.enableAnyNoMotionAxis(BMA423_ALL_AXIS_EN);
+  _setMotionDetect(false);
+  sensor.enableAnyNoMotionInterrupt();
+  sensor.saveConfig(BMA_SETUP_VERSION);
+}
+
+void Watchy::_logSteps() {
+  // RTC budi sat bar jednom na sat (MAX_SLEEP_MIN), propušteni sati se
+  // zatvaraju naknadno, pa reset brojača u ponoć ne zavisi od crtanja u 00:00
+  if (stepLog.update(makeTime(currentTime), sensor.getCounter(),
+                     sensor.getActivityState())) {
+    sensor.resetStepCounter();
+  }
+}
+
+void Watchy::_setMotionDetect(bool stationary) {
+  // The any/no-motion engine runs one direction at a time: look for no-motion
+  // while worn and for any-motion while lying still
+  sensor.getINT(); // drop the event latched in the previous direction
+  sensor.setAnyNoMotionConfig(stationary ? ANY_MOTION_DURATION
+                                         : NO_MOTION_DURATION,
+                              MOTION_THRESHOLD, !stationary);
+  watchStationary = stationary;
+}
+
+void Watchy::_handleAccelWake() {
+  sensor.getINT();
+  bool raised        = sensor.isTilt() || sensor.isDoubleClick();
+  bool wasStationary = watchStationary;
+  if (wasStationary) {
+    _setMotionDetect(false); // watch was picked up, resume minute ticks
+  } else if (sensor.isAnyNoMotion()) {
+    _setMotionDetect(true);  // on-demand mode also wakes on no-motion
+  }
+  if (guiState != WATCHFACE_STATE) {
+    return;
+  }
+  // Catch up on ticks skipped while stationary; on-demand waits for a raise
+  if (raised || (wasStationary && !settings.onDemandDisplay)) {
+    RTC.read(currentTime);
+    showWatchFace(true);
+  }
+}
+
+bool Watchy::_isStationary() {
+  // INT1 is not a wake source while worn, so poll the latched status per tick
+  if (!watchStationary && sensor.getINT() && sensor.isAnyNoMotion()) {
+    _setMotionDetect(true);
+  }
+  return watchStationary;
 }
 
 void Watchy::setupWifi() {
@@ -2089,8 +3101,7 @@ if (WiFi.status() == WL_CONNECTED) {
         delay(120); 
 
         weatherIntervalCounter = -1;
-        lastIPAddress = WiFi.localIP();
-        WiFi.SSID().toCharArray(lastSSID, 30);
+        _cacheWiFi();
         return;
       }
 
@@ -2129,6 +3140,13 @@ void Watchy::_configModeCallback(WiFiManager *myWiFiManager) {
 }
 
 bool Watchy::connectWiFi() {
+  if (WiFi.status() == WL_CONNECTED) {
+    return true;
+  }
+  if (_fastConnectWiFi()) {
+    WIFI_CONFIGURED = true;
+    return true;
+  }
   if (WL_CONNECT_FAILED ==
       WiFi.begin()) { // WiFi not setup, you can also use hard coded credentials
                       // with WiFi.begin(SSID,PASS);
@@ -2136,8 +3154,7 @@ bool Watchy::connectWiFi() {
   } else {
     if (WL_CONNECTED ==
         WiFi.waitForConnectResult()) { // attempt to connect for 10s
-      lastIPAddress = WiFi.localIP();
-      WiFi.SSID().toCharArray(lastSSID, 30);
+      _cacheWiFi();
       WIFI_CONFIGURED = true;
     } else { // connection failed, time out
       WIFI_CONFIGURED = false;
@@ -2151,6 +3168,52 @@ bool Watchy::connectWiFi() {
   return WIFI_CONFIGURED;
 }
 
+bool Watchy::_fastConnectWiFi() {
+  // Skip the scan and DHCP: associate straight to the cached BSSID/channel
+  // with the last lease, using the credentials stored by WiFiManager
+  if (lastChannel == 0) {
+    return false;
+  }
+  WiFi.mode(WIFI_STA);
+  wifi_config_t conf;
+  if (esp_wifi_get_config(WIFI_IF_STA, &conf) != ESP_OK ||
+      conf.sta.ssid[0] == 0) {
+    return false;
+  }
+  // a full length ssid (32) or password (64) is not NUL terminated
+  char ssid[sizeof(conf.sta.ssid) + 1];
+  char pass[sizeof(conf.sta.password) + 1];
+  memcpy(ssid, conf.sta.ssid, sizeof(conf.sta.ssid));
+  memcpy(pass, conf.sta.password, sizeof(conf.sta.password));
+  ssid[sizeof(conf.sta.ssid)]     = 0;
+  pass[sizeof(conf.sta.password)] = 0;
+  WiFi.config(IPAddress(lastIPAddress), IPAddress(lastGateway),
+              IPAddress(lastSubnet), IPAddress(lastDNS));
+  WiFi.begin(ssid, pass, lastChannel, lastBSSID);
+  unsigned long start = millis();
+  while (WiFi.status() != WL_CONNECTED) {
+    if (millis() - start > WIFI_FAST_TIMEOUT) {
+      // AP moved or lease is gone, forget it and scan with DHCP
+      lastChannel = 0;
+      WiFi.disconnect();
+      WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+      return false;
+    }
+    delay(10);
+  }
+  return true;
+}
+
+void Watchy::_cacheWiFi() {
+  lastIPAddress = WiFi.localIP();
+  WiFi.SSID().toCharArray(lastSSID, 30);
+  memcpy(lastBSSID, WiFi.BSSID(), sizeof(lastBSSID));
+  lastChannel = WiFi.channel();
+  lastGateway = WiFi.gatewayIP();
+  lastSubnet  = WiFi.subnetMask();
+  lastDNS     = WiFi.dnsIP();
+}
+
 void Watchy::showUpdateFW() {
   display.setFullWindow();
   display.fillScreen(GxEPD_BLACK);
@@ -2164,7 +3227,7 @@ void Watchy::showUpdateFW() {
   display.println(" ");
   display.println("Press menu button");
   display.println("again when ready");
-  display.println(" ");
+  display.println("DOWN: over Wi-Fi");
   display.println("Keep USB powered");
   display.display(false); // full refresh
 
@@ -2257,6 +3320,141 @@ void Watchy::updateFWBegin() {
   showMenu(menuIndex, false);
 }
 
+void Watchy::updateFWHttp() {
+  display.setFullWindow();
+  display.fillScreen(GxEPD_BLACK);
+  display.setFont(&FreeMonoBold9pt7b);
+  display.setTextColor(GxEPD_WHITE);
+  display.setCursor(0, 30);
+  display.println("Wi-Fi OTA");
+  display.println(" ");
+  display.println("Connecting...");
+  display.display(false); // full refresh
+
+  const char *error = NULL;
+  esp_err_t err     = ESP_FAIL;
+  uint32_t done = 0, total = 0;
+  unsigned long t0 = 0;
+  if (!connectWiFi()) {
+    error = "WiFi failed";
+  } else {
+    RTC.read(currentTime);
+    HTTPClient &http = netHttp;
+    const char *headers[] = {"X-Image-SHA256"};
+    http.begin(taskServerURL(makeTime(currentTime), false) + "/firmware");
+    http.collectHeaders(headers, 1);
+    int httpCode = http.GET();
+    int size = http.getSize();
+    const esp_partition_t *part = esp_ota_get_next_update_partition(NULL);
+    esp_ota_handle_t ota;
+    uint8_t want[32];
+    if (httpCode != 200) {
+      error = "Server error";
+    } else if (!parseSha256(http.header("X-Image-SHA256").c_str(), want)) {
+      error = "No SHA-256";
+    } else if (size <= 0 || (uint32_t)size > part->size) {
+      error = "Bad image size";
+    } else if (esp_ota_begin(part, size, &ota) != ESP_OK) {
+      error = "OTA begin failed";
+    } else {
+      // stream -> esp_ota_write u komadima, slika nikad nije cela u RAM-u
+      static uint8_t buf[OTA_HTTP_CHUNK];
+      WiFiClient *stream = http.getStreamPtr();
+      total              = size;
+      t0                 = millis();
+      unsigned long lastData = t0;
+      uint32_t shown = 0;
+      mbedtls_sha256_context sha;
+      mbedtls_sha256_init(&sha);
+      mbedtls_sha256_starts(&sha, 0);
+      err = ESP_OK;
+      _drawOTAProgress(0, total);
+      while (err == ESP_OK && done < total) {
+        size_t avail = stream->available();
+        if (avail == 0) {
+          if (!http.connected() || millis() - lastData > 5000) {
+            err = ESP_ERR_TIMEOUT;
+            break;
+          }
+          delay(1);
+          continue;
+        }
+        int n = stream->readBytes(buf, min(avail, min(sizeof(buf), (size_t)(total - done))));
+        mbedtls_sha256_update(&sha, buf, n);
+        err = esp_ota_write(ota, buf, n);
+        done += n;
+        lastData = millis();
+        if ((done - shown) * 100 >= total * OTA_PROGRESS_STEP) {
+          shown = done;
+          _drawOTAProgress(done, total);
+        }
+      }
+      if (err == ESP_OK) {
+        err = esp_ota_end(ota);
+      } else {
+        esp_ota_abort(ota);
+      }
+      uint8_t got[32];
+      mbedtls_sha256_finish(&sha, got);
+      mbedtls_sha256_free(&sha);
+      if (err == ESP_OK && memcmp(got, want, 32) != 0) {
+        err   = ESP_ERR_INVALID_CRC;
+        error = "SHA-256 mismatch";
+      }
+      if (err == ESP_OK) {
+        err = esp_ota_set_boot_partition(part);
+      }
+      if (err != ESP_OK && error == NULL) {
+        error = "Flash failed";
+      }
+    }
+    http.end();
+  }
+  WiFi.mode(WIFI_OFF);
+
+  unsigned long ms = max(1UL, millis() - t0);
+  Serial.printf("HTTP OTA: %u B in %lu ms, %lu KB/s, err %d\n", done, ms,
+                done / ms, err);
+  display.setFullWindow();
+  display.fillScreen(GxEPD_BLACK);
+  display.setCursor(0, 30);
+  if (error == NULL) {
+    display.println("Download");
+    display.println("completed!");
+    display.print(done / ms);
+    display.println(" KB/s");
+    display.println("Rebooting...");
+    display.display(false); // full refresh
+    delay(2000);
+    esp_restart();
+  }
+  display.println(error);
+  display.println(" ");
+  display.println("exiting...");
+  display.display(false); // full refresh
+  delay(2000);
+  showMenu(menuIndex, false);
+}
+
+void Watchy::_drawOTAProgress(uint32_t done, uint32_t total) {
+  // samo traka i procenat na dnu, ostatak ekrana se ne osvežava
+  const int y = 152;
+  int fill    = total ? (uint64_t)done * 180 / total : 0;
+  display.setPartialWindow(0, y, DISPLAY_WIDTH, DISPLAY_HEIGHT - y);
+  display.firstPage();
+  do {
+    display.fillScreen(GxEPD_BLACK);
+    display.drawRect(8, y + 2, 184, 14, GxEPD_WHITE);
+    display.fillRect(10, y + 4, fill, 10, GxEPD_WHITE);
+    display.setTextColor(GxEPD_WHITE);
+    display.setCursor(8, y + 36);
+    display.print(total ? (unsigned long)((uint64_t)done * 100 / total) : 0UL);
+    display.print("% ");
+    display.print(done / 1024);
+    display.print(" KB");
+  } while (display.nextPage());
+}
+
 void Watchy::showSyncNTP() {
   display.setFullWindow();
   display.fillScreen(GxEPD_BLACK);
@@ -2264,8 +3462,13 @@ void Watchy::showSyncNTP() {
   display.setTextColor(GxEPD_WHITE);
   display.setCursor(0, 30);
   display.println("Syncing NTP... ");
-  display.print("GMT offset: ");
-  display.println(gmtOffset);
+  if (RTC.tz.active()) {
+    display.print("Zone: ");
+    display.println(RTC.tz.zoneName());
+  } else {
+    display.print("GMT offset: ");
+    display.println(gmtOffset);
+  }
   display.display(false); // full refresh
   if (connectWiFi()) {
     if (syncNTP()) {
@@ -2320,8 +3523,14 @@ bool Watchy::syncNTP(long gmt, String ntpServer) {
   if (!timeClient.forceUpdate()) {
     return false; // NTP sync failed
   }
-  tmElements_t tm;
-  breakTime((time_t)timeClient.getEpochTime(), tm);
-  RTC.set(tm);
+  time_t epoch = (time_t)timeClient.getEpochTime();
+  if (RTC.tz.active()) {
+    epoch -= gmt; // zone rules win over gmt, the clock keeps UTC
+  }
+  #ifdef ARDUINO_ESP32S3_DEV
+  RTC.calibrate(epoch); // sets the time and refines the drift estimate
+  #else
+  RTC.setUTC(epoch);
+  #endif
   return true;
 }
@@ -15,6 +15,10 @@
 #include "BLE.h"
 #include "bma.h"
 #include "config.h"
+#include "WatchyScheduler.h"
+#include "WatchyOpLog.h"
+#include "WatchyStepLog.h"
+#include "WatchyBus.h"
 #include "esp_chip_info.h"
 #ifdef ARDUINO_ESP32S3_DEV
   #include "Watchy32KRTC.h"
@@ -58,8 +62,14 @@ typedef struct watchySettings {
   // NTP Settings
   String ntpServer;
   int gmtOffset;
+  // Zone compiled into tz_rules.h, e.g. "Europe/Belgrade"; the RTC then keeps
+  // UTC, DST is applied on read and gmtOffset is ignored. Sync NTP once after
+  // enabling it.
+  String timezone;
   //
   bool vibrateOClock;
+  // Only redraw the watchface on wrist raise / double tap
+  bool onDemandDisplay;
 } watchySettings;
 
 typedef struct watchyAlarm { // Struct of Alarm
@@ -81,6 +91,9 @@ public:
    static WatchyRTC RTC;
   #endif
   static GxEPD2_BW<WatchyDisplay, WatchyDisplay::HEIGHT> display;
+  static WatchyScheduler scheduler;
+  static WatchyOpLog taskLog;
+  static WatchyStepLog stepLog;
   tmElements_t currentTime;
   watchySettings settings;
 
@@ -107,9 +120,14 @@ public:
   void setupWifi();
   void setAlarm();
   void showAlarm();
-  void fetchTaskData();
+  void startTimer(uint32_t seconds, uint8_t tag = 0);
+  virtual void runJob(const watchyJob &job); // override to handle own jobs
+  static bool isNetJob(uint8_t type);
+  uint32_t radioOnMs(); // Wi-Fi session time today
+  void fetchTaskData(bool online = true); // online = false: static JSON only
   void taskTimes();
   void startSyncAP();
+  void stopSyncAP();
   void measureTickIfNeeded();
 
   void deleteRow(int row);
@@ -118,6 +136,7 @@ public:
   bool connectWiFi();
   weatherData getWeatherData();
   void updateFWBegin();
+  void updateFWHttp();
 
   void showWatchFace(bool partialRefresh);
   virtual void drawWatchFace(); // override this method for different watch
@@ -125,11 +144,21 @@ public:
 
 private:
   void _bmaConfig();
+  void _setMotionDetect(bool stationary);
+  bool _isStationary();
+  void _handleAccelWake();
+  void _logSteps();
+  time_t _nextWake();
+  void _runDueJobs();
+  bool _netBegin();
+  void _netEnd();
+  uint32_t _taskOpTime();
+  void _scheduleTaskPush(uint16_t delayMin);
+  void _logSyncPush();
   static void _configModeCallback(WiFiManager *myWiFiManager);
-  static uint16_t _readRegister(uint8_t address, uint8_t reg, uint8_t *data,
-                                uint16_t len);
-  static uint16_t _writeRegister(uint8_t address, uint8_t reg, uint8_t *data,
-                                 uint16_t len);
+  bool _fastConnectWiFi();
+  void _cacheWiFi();
+  void _drawOTAProgress(uint32_t done, uint32_t total);
   weatherData _getWeatherData(String cityID, String lat, String lon, String units, String lang,
                              String url, String apiKey, uint8_t updateInterval);                                 
 };
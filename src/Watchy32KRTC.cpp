@@ -1,5 +1,10 @@
 #include "Watchy32KRTC.h"
 
+// Slow clock drift learned between NTP syncs, positive when running fast
+RTC_DATA_ATTR float driftPpm         = 0;
+RTC_DATA_ATTR time_t lastSyncTime    = 0; // last NTP reference, 0 = none
+RTC_DATA_ATTR time_t lastDriftAdjust = 0; // when the correction was last applied
+
 Watchy32KRTC::Watchy32KRTC(){}
 
 void Watchy32KRTC::init() {
@@ -24,26 +29,31 @@ void Watchy32KRTC::config(String datetime) { // String datetime format is YYYY:M
 
     // Convert tm to timeval
     struct timeval tv;
-    tv.tv_sec = mktime(&timeInfo);
+    tv.tv_sec = tz.toUTC(mktime(&timeInfo));
     tv.tv_usec = 0;
 
     // Set the time using settimeofday
     if (settimeofday(&tv, NULL) != 0) {
         // Error setting the time
     }
+    lastSyncTime    = 0;
+    lastDriftAdjust = tv.tv_sec;
 }
 
-void Watchy32KRTC::clearAlarm() {
+void Watchy32KRTC::clearAlarm(time_t nextWake) {
+  // wake up timer is armed in Watchy::deepSleep()
 
 }
 
 void Watchy32KRTC::read(tmElements_t &tm) {
+  _applyDrift();
   time_t now;
   struct tm timeInfo;
   time(&now);
   // Set timezone to China Standard Time
   //setenv("TZ", "CST-8", 1);
   //tzset();
+  now = tz.toLocal(now);
   localtime_r(&now, &timeInfo);
   tm.Year   = timeInfo.tm_year - 70;
   tm.Month  = timeInfo.tm_mon + 1;
@@ -63,15 +73,43 @@ void Watchy32KRTC::set(tmElements_t tm) {
   timeInfo.tm_min  = tm.Minute;
   timeInfo.tm_sec  = tm.Second;
 
-  // Convert tm to timeval
+  setUTC(tz.toUTC(mktime(&timeInfo)));
+}
+
+void Watchy32KRTC::setUTC(time_t t) {
+  _setTime(t);
+  // a hand set time is no reference for the drift estimate
+  lastSyncTime    = 0;
+  lastDriftAdjust = t;
+}
+
+void Watchy32KRTC::calibrate(time_t ref) {
+  _applyDrift();
+  time_t now;
+  time(&now);
+  if (lastSyncTime != 0 && ref - lastSyncTime >= DRIFT_MIN_SYNC_SEC) {
+    // error left over after the current correction, relative to the interval
+    float residual = (float)(now - ref) * 1e6f / (float)(ref - lastSyncTime);
+    driftPpm = constrain(driftPpm + residual, -DRIFT_MAX_PPM, DRIFT_MAX_PPM);
+  }
+  _setTime(ref);
+  lastSyncTime    = ref;
+  lastDriftAdjust = ref;
+}
+
+uint64_t Watchy32KRTC::sleepMicros(time_t nextWake) {
+  _applyDrift();
   struct timeval tv;
-  tv.tv_sec = mktime(&timeInfo);
-  tv.tv_usec = 0;
-  
-  // Set the time using settimeofday
-  if (settimeofday(&tv, NULL) != 0) {
-      // Error setting the time
-  }  
+  gettimeofday(&tv, NULL);
+  time_t target = nextWake != 0 ? tz.toUTC(nextWake)
+                                 : tv.tv_sec - tv.tv_sec % 60 + 60;
+  int64_t us    = (int64_t)(target - tv.tv_sec) * 1000000LL - tv.tv_usec;
+  if (us < 1000) {
+    us = 1000;
+  }
+  // the sleep timer runs off the same clock, stretch it by the drift so the
+  // corrected time lands on the target
+  return (uint64_t)(us * (1.0 + driftPpm / 1e6));
 }
 
 uint8_t Watchy32KRTC::temperature() {
@@ -94,6 +132,31 @@ String Watchy32KRTC::_getValue(String data, char separator, int index) {
   return found > index ? data.substring(strIndex[0], strIndex[1]) : "";
 }
 
+void Watchy32KRTC::_applyDrift() {
+  if (driftPpm == 0 || lastDriftAdjust == 0) {
+    return;
+  }
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  float correction = (float)(tv.tv_sec - lastDriftAdjust) * driftPpm / 1e6f;
+  if (fabsf(correction) < 0.1f) {
+    return; // let it pile up, settimeofday is not free
+  }
+  int64_t us = (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec -
+               (int64_t)(correction * 1e6f);
+  tv.tv_sec  = us / 1000000LL;
+  tv.tv_usec = us % 1000000LL;
+  settimeofday(&tv, NULL);
+  lastDriftAdjust = tv.tv_sec;
+}
+
+void Watchy32KRTC::_setTime(time_t t) {
+  struct timeval tv;
+  tv.tv_sec  = t;
+  tv.tv_usec = 0;
+  settimeofday(&tv, NULL);
+}
+
 void Watchy32KRTC::_timeval_to_tm(struct timeval *tv, struct tm *tm) {
   // Get the seconds and microseconds from the timeval struct
   time_t seconds = tv->tv_sec;
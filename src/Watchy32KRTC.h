@@ -4,20 +4,29 @@
 #include <Arduino.h>
 #include <TimeLib.h>
 #include "config.h"
+#include "WatchyTZ.h"
 
 class Watchy32KRTC {
+public:
+  WatchyTZ tz; // when a zone is set the system time is UTC
+
 public:
   Watchy32KRTC();
   void init();
   void config(String datetime); //datetime format is YYYY:MM:DD:HH:MM:SS
-  void clearAlarm();
+  void clearAlarm(time_t nextWake = 0);
   void read(tmElements_t &tm);
   void set(tmElements_t tm);
+  void setUTC(time_t t); // system time as is: UTC once a zone is set
+  void calibrate(time_t t); // set from NTP and learn the drift
+  uint64_t sleepMicros(time_t nextWake = 0); // 0 = next minute
   uint8_t temperature();
 
 private:
   String _getValue(String data, char separator, int index);
   void _timeval_to_tm(struct timeval *tv, struct tm *tm);
+  void _applyDrift();
+  void _setTime(time_t t);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "WatchyBus.h"
+
+// FIFO port šalje ponovo okvir pročitan samo delom, pa se deli na cele okvire
+#define BUS_FIFO_CHUNK                                                         \
+  (I2C_BUFFER_LENGTH - I2C_BUFFER_LENGTH % BMA4_FIFO_A_LENGTH)
+
+uint16_t bmaBusRead(uint8_t address, uint8_t reg, uint8_t *data,
+                    uint16_t len) {
+  // Wire buffer je manji od najdužeg burst-a: deli se na delove, FIFO port
+  // nastavlja sa istog registra, ostali registri se auto-inkrementiraju
+  bool fifo      = reg == BMA4_FIFO_DATA_ADDR;
+  uint16_t chunk = fifo ? BUS_FIFO_CHUNK : I2C_BUFFER_LENGTH;
+  uint16_t done  = 0;
+  while (done < len) {
+    uint16_t n = min((uint16_t)(len - done), chunk);
+    Wire.beginTransmission(address);
+    Wire.write(fifo ? reg : (uint8_t)(reg + done));
+    if (Wire.endTransmission() != 0 ||
+        Wire.requestFrom((uint16_t)address, (size_t)n, true) != n) {
+      return 1;
+    }
+    Wire.readBytes(data + done, n);
+    done += n;
+  }
+  return 0;
+}
+
+uint16_t bmaBusWrite(uint8_t address, uint8_t reg, uint8_t *data,
+                     uint16_t len) {
+  uint16_t done = 0;
+  do {
+    uint16_t n = min((uint16_t)(len - done), (uint16_t)(I2C_BUFFER_LENGTH - 1));
+    Wire.beginTransmission(address);
+    Wire.write((uint8_t)(reg + done));
+    Wire.write(data + done, n);
+    if (Wire.endTransmission() != 0) {
+      return 1;
+    }
+    done += n;
+  } while (done < len);
+  return 0;
+}
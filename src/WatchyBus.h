@@ -0,0 +1,15 @@
+#ifndef WATCHY_BUS_H
+#define WATCHY_BUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "bma.h"
+
+// BMA423 bus callbacks over Wire (bma4_com_fptr_t). Bursts longer than the
+// Wire buffer are split; 0 = OK.
+uint16_t bmaBusRead(uint8_t address, uint8_t reg, uint8_t *data,
+                    uint16_t len);
+uint16_t bmaBusWrite(uint8_t address, uint8_t reg, uint8_t *data,
+                     uint16_t len);
+
+#endif
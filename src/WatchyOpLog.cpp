@@ -0,0 +1,111 @@
+#include "WatchyOpLog.h"
+
+RTC_DATA_ATTR taskOp opLog[MAX_OPS];
+RTC_DATA_ATTR uint8_t numOps       = 0;
+RTC_DATA_ATTR bool opLogOverflow   = false;
+static portMUX_TYPE opLogMux       = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *opNames[] = {"add", "resetRow", "resetCol"};
+
+WatchyOpLog::WatchyOpLog() {}
+
+void WatchyOpLog::add(uint8_t row, uint8_t col, int16_t minutes,
+                      uint32_t time) {
+  portENTER_CRITICAL(&opLogMux);
+  bool merged = false;
+  for (uint8_t i = 0; i < numOps; i++) {
+    if (opLog[i].kind == OP_ADD && opLog[i].row == row &&
+        opLog[i].col == col) {
+      opLog[i].value += minutes;
+      opLog[i].time = time;
+      merged        = true;
+      break;
+    }
+  }
+  if (!merged) {
+    taskOp op = {time, minutes, OP_ADD, row, col};
+    _append(op);
+  }
+  portEXIT_CRITICAL(&opLogMux);
+}
+
+void WatchyOpLog::resetRow(uint8_t row, uint32_t time) {
+  portENTER_CRITICAL(&opLogMux);
+  _dropAdds(row, -1);
+  taskOp op = {time, 0, OP_RESET_ROW, row, 0};
+  _append(op);
+  portEXIT_CRITICAL(&opLogMux);
+}
+
+void WatchyOpLog::resetCol(uint8_t col, uint32_t time) {
+  portENTER_CRITICAL(&opLogMux);
+  _dropAdds(-1, col);
+  taskOp op = {time, 0, OP_RESET_COL, 0, col};
+  _append(op);
+  portEXIT_CRITICAL(&opLogMux);
+}
+
+uint8_t WatchyOpLog::count() { return numOps; }
+
+bool WatchyOpLog::overflowed() { return opLogOverflow; }
+
+uint8_t WatchyOpLog::take(taskOp *ops, bool &overflow) {
+  portENTER_CRITICAL(&opLogMux);
+  uint8_t n = numOps;
+  memcpy(ops, opLog, n * sizeof(taskOp));
+  overflow      = opLogOverflow;
+  numOps        = 0;
+  opLogOverflow = false;
+  portEXIT_CRITICAL(&opLogMux);
+  return n;
+}
+
+void WatchyOpLog::restore(const taskOp *ops, uint8_t n, bool overflow) {
+  portENTER_CRITICAL(&opLogMux);
+  if (n + numOps > MAX_OPS) {
+    overflow = true;
+    n        = MAX_OPS - numOps;
+  }
+  memmove(&opLog[n], opLog, numOps * sizeof(taskOp));
+  memcpy(opLog, ops, n * sizeof(taskOp));
+  numOps += n;
+  opLogOverflow = opLogOverflow || overflow;
+  portEXIT_CRITICAL(&opLogMux);
+}
+
+void WatchyOpLog::toJson(const taskOp *ops, uint8_t n, JsonArray out) {
+  for (uint8_t i = 0; i < n; i++) {
+    JsonObject o = out.createNestedObject();
+    o["t"]       = ops[i].time;
+    o["op"]      = opNames[ops[i].kind];
+    if (ops[i].kind != OP_RESET_COL) {
+      o["r"] = ops[i].row;
+    }
+    if (ops[i].kind != OP_RESET_ROW) {
+      o["c"] = ops[i].col;
+    }
+    if (ops[i].kind == OP_ADD) {
+      o["v"] = ops[i].value;
+    }
+  }
+}
+
+void WatchyOpLog::_append(const taskOp &op) {
+  if (numOps >= MAX_OPS) {
+    opLogOverflow = true; // older edits are lost, upload a snapshot
+    return;
+  }
+  opLog[numOps++] = op;
+}
+
+void WatchyOpLog::_dropAdds(int16_t row, int16_t col) {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < numOps; i++) {
+    bool covered = opLog[i].kind == OP_ADD &&
+                   (opLog[i].row == row || opLog[i].col == col);
+    if (!covered) {
+      opLog[n++] = opLog[i];
+    }
+  }
+  numOps = n;
+}
@@ -0,0 +1,44 @@
+#ifndef WATCHY_OP_LOG_H
+#define WATCHY_OP_LOG_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "config.h"
+
+// Op kinds
+#define OP_ADD       0 // value minutes added to a cell
+#define OP_RESET_ROW 1
+#define OP_RESET_COL 2
+
+typedef struct taskOp {
+  uint32_t time; // RTC time of the last edit folded into this op
+  int16_t value;
+  uint8_t kind;  // OP_*
+  uint8_t row;
+  uint8_t col;
+} taskOp;
+
+// Task table edits kept in RTC memory until they are uploaded in one batch.
+// Adds to the same cell are coalesced and a reset drops the adds it
+// overwrites. If the log fills up only a full snapshot can be trusted, so
+// overflowed() asks the uploader to send the whole table instead.
+class WatchyOpLog {
+public:
+  WatchyOpLog();
+  void add(uint8_t row, uint8_t col, int16_t minutes, uint32_t time);
+  void resetRow(uint8_t row, uint32_t time);
+  void resetCol(uint8_t col, uint32_t time);
+  uint8_t count();
+  bool overflowed();
+  // Move the log out for upload, then hand it back with restore() if the
+  // upload failed. Edits made in between stay after the restored ones.
+  uint8_t take(taskOp *ops, bool &overflow);
+  void restore(const taskOp *ops, uint8_t n, bool overflow);
+  static void toJson(const taskOp *ops, uint8_t n, JsonArray out);
+
+private:
+  void _append(const taskOp &op);
+  void _dropAdds(int16_t row, int16_t col);
+};
+
+#endif
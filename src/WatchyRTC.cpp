@@ -1,8 +1,20 @@
 #include "WatchyRTC.h"
 
+// Survive deep sleep so a wake costs one burst read and at most two writes
+RTC_DATA_ATTR uint8_t cachedRtcType = 0;
+RTC_DATA_ATTR uint8_t rtcControl    = 0; // PCF8563 control 2 / DS3231 status
+RTC_DATA_ATTR uint8_t rtcAlarm[4]   = {0}; // last alarm registers written
+
+static uint8_t bcd2dec(uint8_t v) { return (v >> 4) * 10 + (v & 0x0F); }
+static uint8_t dec2bcd(uint8_t v) { return ((v / 10) << 4) | (v % 10); }
+
 WatchyRTC::WatchyRTC() : rtc_ds(Wire) {}
 
 void WatchyRTC::init() {
+  if (cachedRtcType != 0) {
+    rtcType = cachedRtcType; // probed on a previous boot
+    return;
+  }
   byte error;
   Wire.beginTransmission(RTC_DS_ADDR);
   error = Wire.endTransmission();
@@ -15,8 +27,10 @@ void WatchyRTC::init() {
       rtcType = PCF8563;
     } else {
       // RTC Error
+      return;
     }
   }
+  cachedRtcType = rtcType;
 }
 
 void WatchyRTC::config(
@@ -28,45 +42,81 @@ void WatchyRTC::config(
   }
 }
 
-void WatchyRTC::clearAlarm() {
+void WatchyRTC::clearAlarm(time_t nextWake) {
+  // alarms only match down to the minute, never fire before nextWake
+  tmElements_t at;
+  if (nextWake != 0) {
+    nextWake = tz.toUTC(nextWake);
+    breakTime((nextWake + SECS_PER_MIN - 1) / SECS_PER_MIN * SECS_PER_MIN, at);
+  }
+  uint8_t alarm[4] = {RTC_ALARM_OFF, RTC_ALARM_OFF, RTC_ALARM_OFF,
+                      RTC_ALARM_OFF};
   if (rtcType == DS3231) {
-    rtc_ds.alarm(DS3232RTC::ALARM_2);
+    // alarm 2: minute, hour, date; all "don't care" fires every minute
+    if (nextWake != 0) {
+      alarm[0] = dec2bcd(at.Minute);
+      alarm[1] = dec2bcd(at.Hour);
+      alarm[2] = dec2bcd(at.Day);
+    }
+    if (memcmp(alarm, rtcAlarm, 3) != 0) {
+      _writeRegs(RTC_DS_ADDR, DS_ALARM_2, alarm, 3);
+      memcpy(rtcAlarm, alarm, 3);
+    }
+    uint8_t status = rtcControl & ~DS_A2F;
+    _writeRegs(RTC_DS_ADDR, DS_STATUS, &status, 1);
   } else {
-    int nextAlarmMinute = 0;
-    rtc_pcf.clearAlarm(); // resets the alarm flag in the RTC
-    nextAlarmMinute = rtc_pcf.getMinute();
-    nextAlarmMinute =
-        (nextAlarmMinute == 59)
-            ? 0
-            : (nextAlarmMinute + 1); // set alarm to trigger 1 minute from now
-    rtc_pcf.setAlarm(nextAlarmMinute, 99, 99, 99);
+    // minute, hour, day, weekday
+    if (nextWake != 0) {
+      alarm[0] = dec2bcd(at.Minute);
+      alarm[1] = dec2bcd(at.Hour);
+      alarm[2] = dec2bcd(at.Day);
+    } else { // set alarm to trigger 1 minute from now
+      alarm[0] = dec2bcd((_currentMinute() + 1) % 60);
+    }
+    if (memcmp(alarm, rtcAlarm, 4) != 0) {
+      _writeRegs(RTC_PCF_ADDR, PCF_ALARM, alarm, 4);
+      memcpy(rtcAlarm, alarm, 4);
+    }
+    uint8_t control = rtcControl & ~PCF_AF; // resets the alarm flag in the RTC
+    _writeRegs(RTC_PCF_ADDR, PCF_CONTROL_2, &control, 1);
   }
 }
 
 void WatchyRTC::read(tmElements_t &tm) {
   if (rtcType == DS3231) {
-    rtc_ds.read(tm);
+    rtc_ds.read(tm); // already a single burst
   } else {
-    rtc_pcf.getDate();
-    tm.Year  = y2kYearToTm(rtc_pcf.getYear());
-    tm.Month = rtc_pcf.getMonth();
-    tm.Day   = rtc_pcf.getDay();
-    tm.Wday =
-        rtc_pcf.getWeekday() + 1; // TimeLib & DS3231 has Wday range of 1-7, but
-                                  // PCF8563 stores day of week in 0-6 range
-    tm.Hour   = rtc_pcf.getHour();
-    tm.Minute = rtc_pcf.getMinute();
-    tm.Second = rtc_pcf.getSecond();
+    // seconds, minutes, hours, days, weekdays, months, years in one burst
+    uint8_t regs[7];
+    _readRegs(RTC_PCF_ADDR, PCF_SECONDS, regs, 7);
+    tm.Second = bcd2dec(regs[0] & 0x7F);
+    tm.Minute = bcd2dec(regs[1] & 0x7F);
+    tm.Hour   = bcd2dec(regs[2] & 0x3F);
+    tm.Day    = bcd2dec(regs[3] & 0x3F);
+    tm.Wday   = (regs[4] & 0x07) + 1; // TimeLib & DS3231 has Wday range of 1-7,
+                                      // but PCF8563 stores day of week in 0-6
+    tm.Month  = bcd2dec(regs[5] & 0x1F);
+    tm.Year   = y2kYearToTm(bcd2dec(regs[6]));
+  }
+  _cacheMinute(tm.Minute, tm.Second); // chip minute, alarms are in chip time
+  if (tz.active()) {
+    breakTime(tz.toLocal(makeTime(tm)), tm);
   }
 }
 
 void WatchyRTC::set(tmElements_t tm) {
+  setUTC(tz.toUTC(makeTime(tm)));
+}
+
+void WatchyRTC::setUTC(time_t t) {
+  // a local time in the fall-back hour maps to two UTC times, callers that
+  // know UTC should come here directly
+  _minuteValid = false;
   if (rtcType == DS3231) {
-    time_t t = makeTime(tm);
     rtc_ds.set(t);
   } else {
-    time_t t = makeTime(tm); // make and break to calculate tm.Wday
-    breakTime(t, tm);
+    tmElements_t tm;
+    breakTime(t, tm); // break to calculate tm.Wday
     // day, weekday, month, century(1=1900, 0=2000), year(0-99)
     rtc_pcf.setDate(
         tm.Day, tm.Wday - 1, tm.Month, 0,
@@ -105,6 +155,10 @@ void WatchyRTC::_DSConfig(
   rtc_ds.setAlarm(DS3232RTC::ALM2_EVERY_MINUTE, 0, 0, 0,
                   0); // alarm wakes up Watchy every minute
   rtc_ds.alarmInterrupt(DS3232RTC::ALARM_2, true); // enable alarm interrupt
+  memset(rtcAlarm, RTC_ALARM_OFF, sizeof(rtcAlarm));
+  _readRegs(RTC_DS_ADDR, DS_STATUS, &rtcControl, 1);
+  // writing 0 clears the alarm flags, a 1 leaves OSF as the chip has it
+  rtcControl = (rtcControl & DS_EN32KHZ) | DS_OSF;
 }
 
 void WatchyRTC::_PCFConfig(
@@ -130,9 +184,49 @@ void WatchyRTC::_PCFConfig(
   }
   // on POR event, PCF8563 sets month to 0, which will give an error since
   // months are 1-12
+  _readRegs(RTC_PCF_ADDR, PCF_CONTROL_2, &rtcControl, 1);
+  rtcControl |= PCF_AIE;
+  rtcControl &= ~PCF_AF;
+  memset(rtcAlarm, 0, sizeof(rtcAlarm)); // force the first alarm write
   clearAlarm();
 }
 
+void WatchyRTC::_readRegs(uint8_t address, uint8_t reg, uint8_t *data,
+                          uint8_t len) {
+  Wire.beginTransmission(address);
+  Wire.write(reg);
+  Wire.endTransmission(false); // repeated start
+  Wire.requestFrom(address, len);
+  for (uint8_t i = 0; i < len && Wire.available(); i++) {
+    data[i] = Wire.read();
+  }
+}
+
+void WatchyRTC::_writeRegs(uint8_t address, uint8_t reg, const uint8_t *data,
+                           uint8_t len) {
+  Wire.beginTransmission(address);
+  Wire.write(reg);
+  Wire.write(data, len);
+  Wire.endTransmission();
+}
+
+void WatchyRTC::_cacheMinute(uint8_t minute, uint8_t second) {
+  // second is truncated, up to 1 s of it has already passed
+  _minute        = minute;
+  _minuteValidMs = millis() + (SECS_PER_MIN - 1 - second) * 1000UL;
+  _minuteValid   = true;
+}
+
+uint8_t WatchyRTC::_currentMinute() {
+  if (_minuteValid && (int32_t)(_minuteValidMs - millis()) > 0) {
+    return _minute; // no I2C needed when read() ran this minute
+  }
+  uint8_t regs[2];
+  _readRegs(RTC_PCF_ADDR, PCF_SECONDS, regs, 2);
+  _cacheMinute(bcd2dec(regs[1] & 0x7F), bcd2dec(regs[0] & 0x7F));
+  return _minute;
+}
+
 String WatchyRTC::_getValue(String data, char separator, int index) {
   int found      = 0;
   int strIndex[] = {0, -1};
@@ -5,6 +5,7 @@
 #include "time.h"
 #include <DS3232RTC.h>
 #include <Rtc_Pcf8563.h>
+#include "WatchyTZ.h"
 
 #define DS3231          1
 #define PCF8563         2
@@ -13,22 +14,49 @@
 #define YEAR_OFFSET_DS  1970
 #define YEAR_OFFSET_PCF 2000
 
+// PCF8563 registers
+#define PCF_CONTROL_2   0x01
+#define PCF_SECONDS     0x02
+#define PCF_ALARM       0x09
+#define PCF_AF          0x08
+#define PCF_AIE         0x02
+// DS3231 registers
+#define DS_ALARM_2      0x0B
+#define DS_STATUS       0x0F
+#define DS_A2F          0x02
+#define DS_EN32KHZ      0x08
+#define DS_OSF          0x80
+// alarm register "don't care" bit (AE on PCF8563, AxMx on DS3231)
+#define RTC_ALARM_OFF   0x80
+
 class WatchyRTC {
 public:
   DS3232RTC rtc_ds;
   Rtc_Pcf8563 rtc_pcf;
   uint8_t rtcType;
+  WatchyTZ tz; // when a zone is set the chip keeps UTC
 
 public:
   WatchyRTC();
   void init();
   void config(String datetime); // String datetime format is YYYY:MM:DD:HH:MM:SS
-  void clearAlarm();
+  void clearAlarm(time_t nextWake = 0); // 0 = next minute
   void read(tmElements_t &tm);
   void set(tmElements_t tm);
+  void setUTC(time_t t); // chip time as is: UTC once a zone is set
   uint8_t temperature();
 
 private:
+  // valid for the rest of the minute read in this wake
+  uint8_t _minute         = 0;
+  uint32_t _minuteValidMs = 0;
+  bool _minuteValid       = false;
+
+  void _readRegs(uint8_t address, uint8_t reg, uint8_t *data, uint8_t len);
+  void _writeRegs(uint8_t address, uint8_t reg, const uint8_t *data,
+                  uint8_t len);
+  void _cacheMinute(uint8_t minute, uint8_t second);
+  uint8_t _currentMinute();
   void _DSConfig(String datetime);
   void _PCFConfig(String datetime);
   int _getDayOfWeek(int d, int m, int y);
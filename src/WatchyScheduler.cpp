@@ -0,0 +1,117 @@
+#include "WatchyScheduler.h"
+
+RTC_DATA_ATTR watchyJob jobs[MAX_JOBS];
+RTC_DATA_ATTR uint8_t numJobs = 0;
+
+WatchyScheduler::WatchyScheduler() {}
+
+bool WatchyScheduler::add(uint8_t type, uint8_t tag, time_t due,
+                          uint16_t period, uint16_t slack) {
+  int8_t i = _indexOf(type, tag);
+  if (i >= 0) {
+    _removeAt(i); // re-adding a job moves it
+  } else if (numJobs >= MAX_JOBS) {
+    return false;
+  }
+  if (period != 0 && slack >= period) {
+    // the next run must lie past the slack, or popEarly hands it out again
+    slack = period - 1;
+  }
+  watchyJob job;
+  job.due    = due;
+  job.period = period;
+  job.slack  = slack;
+  job.type   = type;
+  job.tag    = tag;
+  _insert(job);
+  return true;
+}
+
+bool WatchyScheduler::remove(uint8_t type, uint8_t tag) {
+  int8_t i = _indexOf(type, tag);
+  if (i < 0) {
+    return false;
+  }
+  _removeAt(i);
+  return true;
+}
+
+bool WatchyScheduler::find(uint8_t type, uint8_t tag, watchyJob &job) {
+  int8_t i = _indexOf(type, tag);
+  if (i < 0) {
+    return false;
+  }
+  job = jobs[i];
+  return true;
+}
+
+bool WatchyScheduler::popDue(time_t now, watchyJob &job) {
+  if (numJobs == 0 || jobs[0].due > (uint32_t)now) {
+    return false;
+  }
+  job = jobs[0];
+  _removeAt(0);
+  _reschedule(job, now);
+  return true;
+}
+
+bool WatchyScheduler::popEarly(time_t now, watchyJob &job) {
+  for (uint8_t i = 0; i < numJobs; i++) {
+    if (jobs[i].due <= (uint32_t)now + jobs[i].slack * SECS_PER_MIN) {
+      job = jobs[i];
+      _removeAt(i);
+      _reschedule(job, now);
+      return true;
+    }
+  }
+  return false;
+}
+
+time_t WatchyScheduler::nextDue() {
+  return numJobs == 0 ? 0 : jobs[0].due;
+}
+
+uint8_t WatchyScheduler::count() { return numJobs; }
+
+void WatchyScheduler::clear() { numJobs = 0; }
+
+int8_t WatchyScheduler::_indexOf(uint8_t type, uint8_t tag) {
+  for (uint8_t i = 0; i < numJobs; i++) {
+    if (jobs[i].type == type && jobs[i].tag == tag) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void WatchyScheduler::_insert(const watchyJob &job) {
+  // insertion sort, the queue is tiny and stays sorted
+  uint8_t i = numJobs;
+  while (i > 0 && jobs[i - 1].due > job.due) {
+    jobs[i] = jobs[i - 1];
+    i--;
+  }
+  jobs[i] = job;
+  numJobs++;
+}
+
+void WatchyScheduler::_reschedule(const watchyJob &job, time_t now) {
+  if (job.period == 0) {
+    return;
+  }
+  // skip periods missed while the watch was off instead of bursting
+  watchyJob next = job;
+  uint32_t step  = (uint32_t)job.period * SECS_PER_MIN;
+  if ((uint32_t)now > job.due) {
+    next.due += ((uint32_t)now - job.due) / step * step;
+  }
+  next.due += step;
+  _insert(next);
+}
+
+void WatchyScheduler::_removeAt(uint8_t index) {
+  for (uint8_t i = index; i + 1 < numJobs; i++) {
+    jobs[i] = jobs[i + 1];
+  }
+  numJobs--;
+}
@@ -0,0 +1,46 @@
+#ifndef WATCHY_SCHEDULER_H
+#define WATCHY_SCHEDULER_H
+
+#include <Arduino.h>
+#include <TimeLib.h>
+#include "config.h"
+
+// Job types
+#define JOB_ALARM     0
+#define JOB_TIMER     1
+#define JOB_NTP_SYNC  2
+#define JOB_WEATHER   3
+#define JOB_TASK_SYNC 4
+#define JOB_TASK_PUSH 5
+
+typedef struct watchyJob {
+  uint32_t due;    // RTC time, seconds since 1970
+  uint16_t period; // minutes, 0 = one-shot
+  uint16_t slack;  // minutes it may run early to share a Wi-Fi session
+  uint8_t type;    // JOB_*
+  uint8_t tag;     // caller defined, e.g. alarm slot
+} watchyJob;
+
+// Alarms, timers and periodic jobs kept sorted by due time in RTC memory, so
+// the next wake up can be programmed for exactly the earliest one
+class WatchyScheduler {
+public:
+  WatchyScheduler();
+  bool add(uint8_t type, uint8_t tag, time_t due, uint16_t period = 0,
+           uint16_t slack = 0);
+  bool remove(uint8_t type, uint8_t tag);
+  bool find(uint8_t type, uint8_t tag, watchyJob &job);
+  bool popDue(time_t now, watchyJob &job); // reschedules periodic jobs
+  bool popEarly(time_t now, watchyJob &job); // due within its slack
+  time_t nextDue();                        // 0 if nothing is scheduled
+  uint8_t count();
+  void clear();
+
+private:
+  int8_t _indexOf(uint8_t type, uint8_t tag);
+  void _insert(const watchyJob &job);
+  void _removeAt(uint8_t index);
+  void _reschedule(const watchyJob &job, time_t now);
+};
+
+#endif
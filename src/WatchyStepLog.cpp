@@ -0,0 +1,138 @@
+#include "WatchyStepLog.h"
+#include <Preferences.h>
+#include "bma423.h"
+
+#define STEP_LOG_HOURS (STEP_LOG_DAYS * 24)
+#define STEP_MAX       0x3FFF
+
+RTC_DATA_ATTR uint16_t stepHours[STEP_LOG_HOURS]; // [activity:2][steps:14]
+RTC_DATA_ATTR uint8_t stepHead     = 0; // next slot to write
+RTC_DATA_ATTR uint8_t stepFilled   = 0;
+RTC_DATA_ATTR uint32_t stepHour    = 0; // open hour, hours since 1970 local
+RTC_DATA_ATTR uint32_t stepCounter = 0; // sensor counter at the last update
+RTC_DATA_ATTR uint32_t stepOpen    = 0; // steps in the open hour so far
+RTC_DATA_ATTR uint32_t stepDays[STEP_LOG_DAYS]; // closed hours, by day % STEP_LOG_DAYS
+
+WatchyStepLog::WatchyStepLog() {}
+
+bool WatchyStepLog::update(time_t now, uint32_t counter, uint8_t activity) {
+  uint32_t hourNow = now / SECS_PER_HOUR;
+  if (stepHour == 0 || hourNow + STEP_BACK_HOURS < stepHour) {
+    clear(); // first boot or the clock was set back a long way
+    stepHour    = hourNow;
+    stepCounter = counter;
+    return false;
+  }
+  // a counter that went down was reset, by us or by a sensor re-init
+  stepOpen += counter >= stepCounter ? counter - stepCounter : counter;
+  stepCounter = counter;
+
+  if (hourNow < stepHour) {
+    // DST fall-back or an NTP correction: the open hour stays open until
+    // the clock is past it again
+    return false;
+  }
+  if (hourNow - stepHour > STEP_LOG_HOURS) {
+    // off for longer than the ring holds, nothing in it is current anymore
+    clear();
+    stepHour    = hourNow;
+    stepCounter = 0; // the caller resets the sensor
+    return true;
+  }
+  bool newDay = false;
+  while (stepHour < hourNow) {
+    // hours missed after the first one had no wake, so no steps are known
+    _closeHour(activity);
+    activity = BMA423_STATE_INVALID;
+    if (stepHour % 24 == 0) {
+      _closeDay();
+      newDay = true;
+    }
+  }
+  if (newDay) {
+    stepCounter = 0; // the caller resets the sensor
+  }
+  return newDay;
+}
+
+uint16_t WatchyStepLog::hour(uint8_t hoursAgo) {
+  if (hoursAgo >= stepFilled) {
+    return 0;
+  }
+  return stepHours[(stepHead + STEP_LOG_HOURS - 1 - hoursAgo) % STEP_LOG_HOURS] &
+         STEP_MAX;
+}
+
+uint8_t WatchyStepLog::activity(uint8_t hoursAgo) {
+  if (hoursAgo >= stepFilled) {
+    return BMA423_STATE_INVALID;
+  }
+  return stepHours[(stepHead + STEP_LOG_HOURS - 1 - hoursAgo) %
+                   STEP_LOG_HOURS] >> 14;
+}
+
+uint8_t WatchyStepLog::hours() { return stepFilled; }
+
+uint32_t WatchyStepLog::today() {
+  return stepDays[(stepHour / 24) % STEP_LOG_DAYS] + stepOpen;
+}
+
+uint32_t WatchyStepLog::day(uint16_t daysAgo) {
+  if (daysAgo == 0) {
+    return today();
+  }
+  uint32_t dayNum = stepHour / 24 - daysAgo;
+  if (daysAgo < STEP_LOG_DAYS) {
+    return stepDays[dayNum % STEP_LOG_DAYS]; // zeroed when its day began
+  }
+  if (daysAgo >= STEP_FLASH_DAYS) {
+    return 0;
+  }
+  Preferences prefs;
+  prefs.begin("steps", true);
+  uint32_t last  = prefs.getUInt("last", 0);
+  uint32_t steps = 0;
+  if (dayNum <= last && last - dayNum < STEP_FLASH_DAYS) {
+    uint32_t days[STEP_FLASH_DAYS] = {0};
+    prefs.getBytes("days", days, sizeof(days));
+    steps = days[dayNum % STEP_FLASH_DAYS];
+  }
+  prefs.end();
+  return steps;
+}
+
+void WatchyStepLog::clear() {
+  stepHead   = 0;
+  stepFilled = 0;
+  stepOpen   = 0;
+  memset(stepDays, 0, sizeof(stepDays));
+}
+
+void WatchyStepLog::_closeHour(uint8_t activity) {
+  uint32_t steps = min(stepOpen, (uint32_t)STEP_MAX);
+  stepHours[stepHead] = (activity & 0x03) << 14 | steps;
+  stepHead            = (stepHead + 1) % STEP_LOG_HOURS;
+  stepFilled          = min(stepFilled + 1, STEP_LOG_HOURS);
+  stepDays[(stepHour / 24) % STEP_LOG_DAYS] += stepOpen;
+  stepOpen = 0;
+  stepHour++;
+}
+
+void WatchyStepLog::_closeDay() {
+  // stepHour is the first hour of the new day, write out the one before it
+  uint32_t dayNum = stepHour / 24 - 1;
+  uint32_t days[STEP_FLASH_DAYS] = {0};
+  Preferences prefs;
+  prefs.begin("steps", false);
+  uint32_t last = prefs.getUInt("last", 0);
+  prefs.getBytes("days", days, sizeof(days));
+  uint32_t from = max(last + 1, dayNum + 1 - STEP_FLASH_DAYS);
+  for (uint32_t d = from; d < dayNum; d++) {
+    days[d % STEP_FLASH_DAYS] = 0; // days the watch did not count
+  }
+  days[dayNum % STEP_FLASH_DAYS] = stepDays[dayNum % STEP_LOG_DAYS];
+  prefs.putBytes("days", days, sizeof(days));
+  prefs.putUInt("last", dayNum);
+  prefs.end();
+  stepDays[(dayNum + 1) % STEP_LOG_DAYS] = 0;
+}
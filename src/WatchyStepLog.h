@@ -0,0 +1,34 @@
+#ifndef WATCHY_STEP_LOG_H
+#define WATCHY_STEP_LOG_H
+
+#include <Arduino.h>
+#include <TimeLib.h>
+#include "config.h"
+
+// Hourly step history. Every RTC wake feeds the raw BMA423 counter in, only
+// the difference to the previous reading is kept, so the sensor counter may
+// be reset at any time. Closed hours go into a ring of STEP_LOG_DAYS * 24
+// entries in RTC memory, packed as [activity:2][steps:14]. Day totals older
+// than the ring are kept in flash for STEP_FLASH_DAYS days.
+class WatchyStepLog {
+public:
+  WatchyStepLog();
+  // now is local time. Closes every hour boundary passed since the last
+  // call, including missed ones, and returns true when a day boundary was
+  // among them. The caller must then reset the sensor counter, the next
+  // reading is taken to start from 0. A clock set back by up to
+  // STEP_BACK_HOURS keeps the history, more than that clears it.
+  bool update(time_t now, uint32_t counter, uint8_t activity);
+  uint16_t hour(uint8_t hoursAgo);     // 0 = last closed hour
+  uint8_t activity(uint8_t hoursAgo);  // BMA423_USER_*, STATE_INVALID if missed
+  uint8_t hours();                     // closed hours available
+  uint32_t today();                    // since local midnight
+  uint32_t day(uint16_t daysAgo);      // 0 = today, >= STEP_LOG_DAYS from flash
+  void clear();
+
+private:
+  void _closeHour(uint8_t activity);
+  void _closeDay();
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "WatchyTZ.h"
+#include "tz_rules.h"
+
+#define NUM_TZ_RULES (sizeof(tzRules) / sizeof(tzRules[0]))
+
+RTC_DATA_ATTR int8_t tzIndex    = -1; // -1 = RTC keeps local time
+RTC_DATA_ATTR int16_t tzYear    = 0;  // year the DST window below is for
+RTC_DATA_ATTR time_t tzDstStart = 0;  // UTC
+RTC_DATA_ATTR time_t tzDstEnd   = 0;  // UTC
+
+WatchyTZ::WatchyTZ() {}
+
+bool WatchyTZ::setZone(const char *name) {
+  for (uint8_t i = 0; i < NUM_TZ_RULES; i++) {
+    if (strcmp(tzRules[i].name, name) == 0) {
+      tzIndex = i;
+      tzYear  = 0;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WatchyTZ::clearZone() { tzIndex = -1; }
+
+bool WatchyTZ::active() { return tzIndex >= 0; }
+
+const char *WatchyTZ::zoneName() {
+  return tzIndex >= 0 ? tzRules[tzIndex].name : "";
+}
+
+int32_t WatchyTZ::offset(time_t utc) {
+  if (tzIndex < 0) {
+    return 0;
+  }
+  const tzRule &r = tzRules[tzIndex];
+  int32_t seconds = r.stdOffset * SECS_PER_MIN;
+  if (r.dstDelta == 0) {
+    return seconds;
+  }
+  tmElements_t tm;
+  breakTime(utc, tm);
+  if (tzYear != tmYearToCalendar(tm.Year)) {
+    _updateYear(tmYearToCalendar(tm.Year));
+  }
+  bool dst = tzDstStart < tzDstEnd
+                 ? (utc >= tzDstStart && utc < tzDstEnd)
+                 : (utc >= tzDstStart || utc < tzDstEnd); // southern hemisphere
+  return dst ? seconds + r.dstDelta * SECS_PER_MIN : seconds;
+}
+
+time_t WatchyTZ::toLocal(time_t utc) { return utc + offset(utc); }
+
+time_t WatchyTZ::toUTC(time_t local) {
+  if (tzIndex < 0) {
+    return local;
+  }
+  // guess with the standard offset, then use the offset in force there
+  time_t utc = local - tzRules[tzIndex].stdOffset * SECS_PER_MIN;
+  return local - offset(utc);
+}
+
+void WatchyTZ::_updateYear(int year) {
+  const tzRule &r = tzRules[tzIndex];
+  tzDstStart = _transition(year, r.startMonth, r.startWeek, r.startWday,
+                           r.startTime) -
+               r.stdOffset * SECS_PER_MIN;
+  tzDstEnd = _transition(year, r.endMonth, r.endWeek, r.endWday, r.endTime) -
+             (r.stdOffset + r.dstDelta) * SECS_PER_MIN;
+  tzYear = year;
+}
+
+time_t WatchyTZ::_transition(int year, uint8_t month, uint8_t week,
+                             uint8_t wday, int16_t minutes) {
+  // local time of the week'th wday (0 = Sunday) of month, week 5 = last
+  tmElements_t tm = {};
+  tm.Day          = 1;
+  tm.Month        = month;
+  tm.Year         = CalendarYrToTm(year);
+  time_t first    = makeTime(tm);
+  tm.Month        = month == 12 ? 1 : month + 1;
+  tm.Year         = CalendarYrToTm(month == 12 ? year + 1 : year);
+  int monthDays   = (makeTime(tm) - first) / SECS_PER_DAY;
+
+  int firstWday = (first / SECS_PER_DAY + 4) % 7; // 1970-01-01 was Thursday
+  int day       = 1 + (wday - firstWday + 7) % 7 + (week - 1) * 7;
+  while (day > monthDays) {
+    day -= 7;
+  }
+  return first + (day - 1) * SECS_PER_DAY + minutes * SECS_PER_MIN;
+}
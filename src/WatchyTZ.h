@@ -0,0 +1,36 @@
+#ifndef WATCHY_TZ_H
+#define WATCHY_TZ_H
+
+#include <Arduino.h>
+#include <TimeLib.h>
+
+typedef struct tzRule {
+  const char *name;
+  int16_t stdOffset; // minutes east of UTC
+  int16_t dstDelta;  // minutes added during DST, 0 = no DST
+  uint8_t startMonth, startWeek, startWday; // POSIX Mm.w.d, week 5 = last
+  int16_t startTime;                        // minutes, local standard time
+  uint8_t endMonth, endWeek, endWday;
+  int16_t endTime;                          // minutes, local daylight time
+} tzRule;
+
+// UTC <-> local conversion from the rules compiled into tz_rules.h by
+// tz_gen.py. The DST window is computed once per year and kept in RTC memory.
+class WatchyTZ {
+public:
+  WatchyTZ();
+  bool setZone(const char *name); // false if the zone was not compiled in
+  void clearZone();               // back to RTC in local time
+  bool active();
+  const char *zoneName();
+  int32_t offset(time_t utc);     // seconds
+  time_t toLocal(time_t utc);
+  time_t toUTC(time_t local);
+
+private:
+  void _updateYear(int year);
+  time_t _transition(int year, uint8_t month, uint8_t week, uint8_t wday,
+                     int16_t minutes);
+};
+
+#endif
@@ -7,6 +7,33 @@
 #define DEBUG(...)
 #endif
 
+extern "C" const uint8_t bma423_config_file[];
+
+// The sensor keeps its config across ESP32 resets, but RTC_DATA_ATTR is
+// reloaded by the bootloader on every reset that is not a deep sleep wake.
+// Noinit RTC memory survives both and is random after power-on, so a save
+// only counts with the magic word and a matching CRC.
+#define BMA_SAVED_MAGIC 0xB4230A51u
+RTC_NOINIT_ATTR uint32_t bmaSavedMagic;
+RTC_NOINIT_ATTR uint32_t bmaConfigSig;
+RTC_NOINIT_ATTR struct bma4_asic_data bmaAsic;
+RTC_NOINIT_ATTR uint32_t bmaAsicCrc;
+
+static uint32_t savedCrc() {
+  // CRC-32 (IEEE) over the signature and the ASIC address
+  uint8_t buf[sizeof(bmaConfigSig) + sizeof(bmaAsic)];
+  memcpy(buf, &bmaConfigSig, sizeof(bmaConfigSig));
+  memcpy(buf + sizeof(bmaConfigSig), &bmaAsic, sizeof(bmaAsic));
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < sizeof(buf); i++) {
+    crc ^= buf[i];
+    for (int b = 0; b < 8; b++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+  }
+  return ~crc;
+}
+
 BMA423::BMA423() {
   __readRegisterFptr   = nullptr;
   __writeRegisterFptr  = nullptr;
@@ -25,18 +52,8 @@ bool BMA423::begin(bma4_com_fptr_t readCallBlack,
     return true;
   }
 
-  __readRegisterFptr   = readCallBlack;
-  __writeRegisterFptr  = writeCallBlack;
-  __delayCallBlackFptr = delayCallBlack;
-
-  __devFptr.dev_addr       = address;
-  __devFptr.interface      = BMA4_I2C_INTERFACE;
-  __devFptr.bus_read       = readCallBlack;
-  __devFptr.bus_write      = writeCallBlack;
-  __devFptr.delay          = delayCallBlack;
-  __devFptr.read_write_len = 8;
-  __devFptr.resolution     = 12;
-  __devFptr.feature_len    = BMA423_FEATURE_SIZE;
+  _attach(readCallBlack, writeCallBlack, delayCallBlack, address);
+  bmaSavedMagic = 0;
 
   softReset();
 
@@ -68,6 +85,64 @@ bool BMA423::begin(bma4_com_fptr_t readCallBlack,
   return true;
 }
 
+bool BMA423::resume(bma4_com_fptr_t readCallBlack,
+                    bma4_com_fptr_t writeCallBlack,
+                    bma4_delay_fptr_t delayCallBlack, uint32_t signature,
+                    uint8_t address) {
+  if (__init) {
+    return true;
+  }
+  if (bmaSavedMagic != BMA_SAVED_MAGIC || bmaAsicCrc != savedCrc() ||
+      bmaConfigSig != _signature(signature) ||
+      readCallBlack == nullptr || writeCallBlack == nullptr ||
+      delayCallBlack == nullptr) {
+    return false;
+  }
+  _attach(readCallBlack, writeCallBlack, delayCallBlack, address);
+  uint8_t stat = 0;
+  if (bma423_init(&__devFptr) != BMA4_OK ||
+      bma4_read_regs(BMA4_INTERNAL_STAT, &stat, 1, &__devFptr) != BMA4_OK ||
+      stat != BMA4_ASIC_INITIALIZED) {
+    return false; // sensor was reset or lost power on its own
+  }
+  __devFptr.asic_data = bmaAsic;
+  __init              = true;
+  return true;
+}
+
+void BMA423::saveConfig(uint32_t signature) {
+  bmaAsic       = __devFptr.asic_data;
+  bmaConfigSig  = _signature(signature);
+  bmaAsicCrc    = savedCrc();
+  bmaSavedMagic = BMA_SAVED_MAGIC;
+}
+
+void BMA423::_attach(bma4_com_fptr_t readCallBlack,
+                     bma4_com_fptr_t writeCallBlack,
+                     bma4_delay_fptr_t delayCallBlack, uint8_t address) {
+  __readRegisterFptr   = readCallBlack;
+  __writeRegisterFptr  = writeCallBlack;
+  __delayCallBlackFptr = delayCallBlack;
+
+  __devFptr.dev_addr       = address;
+  __devFptr.interface      = BMA4_I2C_INTERFACE;
+  __devFptr.bus_read       = readCallBlack;
+  __devFptr.bus_write      = writeCallBlack;
+  __devFptr.delay          = delayCallBlack;
+  __devFptr.read_write_len = BMA423_BURST_LEN;
+  __devFptr.resolution     = 12;
+  __devFptr.feature_len    = BMA423_FEATURE_SIZE;
+}
+
+uint32_t BMA423::_signature(uint32_t setup) {
+  // FNV-1a of the config blob, so a driver update forces a full upload
+  uint32_t h = 2166136261u ^ setup;
+  for (uint16_t i = 0; i < BMA4_CONFIG_STREAM_SIZE; i++) {
+    h = (h ^ bma423_config_file[i]) * 16777619u;
+  }
+  return h;
+}
+
 void BMA423::softReset() {
   uint8_t reg = BMA4_RESET_ADDR;
   __writeRegisterFptr(BMA4_I2C_ADDR_PRIMARY, BMA4_RESET_SET_MASK, &reg, 1);
@@ -107,6 +182,10 @@ uint8_t BMA423::getDirection() {
   if (bma4_read_accel_xyz(&acc, &__devFptr) != BMA4_OK) {
     return 0;
   }
+  return getDirection(acc);
+}
+
+uint8_t BMA423::getDirection(const Accel &acc) {
   uint16_t absX = abs(acc.x);
   uint16_t absY = abs(acc.y);
   uint16_t absZ = abs(acc.z);
@@ -267,6 +346,103 @@ bool BMA423::enableActivityInterrupt(bool en) {
                                           en, &__devFptr));
 }
 
+bool BMA423::setAnyNoMotionConfig(uint16_t duration, uint16_t threshold,
+                                  bool noMotion) {
+  struct bma423_anymotion_config cfg;
+  cfg.duration     = duration;
+  cfg.threshold    = threshold;
+  cfg.nomotion_sel = noMotion ? 1 : 0;
+  return (BMA4_OK == bma423_set_any_motion_config(&cfg, &__devFptr));
+}
+
+bool BMA423::enableAnyNoMotionAxis(uint8_t axis) {
+  return (BMA4_OK == bma423_anymotion_enable_axis(axis, &__devFptr));
+}
+
+bool BMA423::setInterruptLatch(bool latch) {
+  return (BMA4_OK ==
+          bma4_set_interrupt_mode(latch ? BMA4_LATCH_MODE : BMA4_NON_LATCH_MODE,
+                                  &__devFptr));
+}
+
+bool BMA423::enableFIFO(uint16_t watermark, uint8_t downsample, bool en) {
+  if (!en) {
+    return disableFIFO();
+  }
+  // stream mode without header or sensor time: every frame is 6 bytes
+  uint16_t rslt = bma4_set_fifo_config(BMA4_FIFO_HEADER | BMA4_FIFO_TIME |
+                                           BMA4_FIFO_STOP_ON_FULL | BMA4_FIFO_MAG,
+                                       BMA4_DISABLE, &__devFptr);
+  rslt |= bma4_set_accel_fifo_filter_data(BMA4_ENABLE, &__devFptr);
+  rslt |= bma4_set_fifo_down_accel(downsample, &__devFptr);
+  rslt |= bma4_set_fifo_wm(watermark * BMA4_FIFO_A_LENGTH, &__devFptr);
+  rslt |= bma4_set_fifo_config(BMA4_FIFO_ACCEL, BMA4_ENABLE, &__devFptr);
+  return (BMA4_OK == rslt) && flushFIFO();
+}
+
+bool BMA423::disableFIFO() {
+  return (BMA4_OK ==
+          bma4_set_fifo_config(BMA4_FIFO_ACCEL, BMA4_DISABLE, &__devFptr));
+}
+
+bool BMA423::flushFIFO() {
+  return (BMA4_OK == bma4_set_command_register(0xB0, &__devFptr));
+}
+
+bool BMA423::enableFIFOInterrupt(bool en) {
+  return (BMA4_OK == bma423_map_interrupt(BMA4_INTR1_MAP, BMA4_FIFO_WM_INT, en,
+                                          &__devFptr));
+}
+
+bool BMA423::isFIFOWatermark() {
+  return (bool)(BMA4_FIFO_WM_INT & __IRQ_MASK);
+}
+
+uint16_t BMA423::getFIFOFrames() {
+  uint16_t len = 0;
+  bma4_get_fifo_length(&len, &__devFptr);
+  return len / BMA4_FIFO_A_LENGTH;
+}
+
+uint16_t BMA423::readFIFO(Accel *samples, uint16_t maxSamples) {
+  // one length read, then bursts of whole frames; a partially read frame
+  // would be sent again by the sensor, so chunks never split one
+  uint8_t buf[BMA423_FIFO_CHUNK];
+  uint16_t frames = min(getFIFOFrames(), maxSamples);
+  uint16_t count  = 0;
+  while (count < frames) {
+    uint16_t n = min((uint16_t)(frames - count),
+                     (uint16_t)(BMA423_FIFO_CHUNK / BMA4_FIFO_A_LENGTH));
+    if (__readRegisterFptr(__devFptr.dev_addr, BMA4_FIFO_DATA_ADDR, buf,
+                           n * BMA4_FIFO_A_LENGTH) != BMA4_OK) {
+      break;
+    }
+    // no Bosch parser: it takes any frame starting 0x80,0x00 (x = +8 LSB)
+    // for the empty marker. A whole frame of it means the FIFO was flushed
+    // after the length read.
+    for (uint16_t i = 0; i < n; i++, count++) {
+      const uint8_t *f = buf + i * BMA4_FIFO_A_LENGTH;
+      if (f[0] == 0x80 && f[1] == 0x00 && f[2] == 0x80 && f[3] == 0x00 &&
+          f[4] == 0x80 && f[5] == 0x00) {
+        return count;
+      }
+      // 12 bit values, left aligned
+      samples[count].x = (int16_t)(f[1] << 8 | f[0]) / 0x10;
+      samples[count].y = (int16_t)(f[3] << 8 | f[2]) / 0x10;
+      samples[count].z = (int16_t)(f[5] << 8 | f[4]) / 0x10;
+    }
+  }
+  return count;
+}
+
+uint8_t BMA423::getActivityState() {
+  uint8_t activity;
+  if (bma423_activity_output(&activity, &__devFptr) != BMA4_OK) {
+    return BMA423_STATE_INVALID;
+  }
+  return activity;
+}
+
 const char *BMA423::getActivity() {
   uint8_t activity;
   bma423_activity_output(&activity, &__devFptr);
@@ -17,6 +17,13 @@ enum {
   DIRECTION_DISP_DOWN   = 5
 };
 
+// Config stream bytes per I2C write, the driver allows up to
+// BMA423_FEATURE_SIZE and 6144 must divide evenly
+#define BMA423_BURST_LEN 64
+
+// FIFO burst size: whole headerless frames that fit the 128 byte Wire buffer
+#define BMA423_FIFO_CHUNK 120
+
 typedef struct bma4_accel Accel;
 typedef struct bma4_accel_config Acfg;
 
@@ -29,6 +36,12 @@ public:
   bool begin(bma4_com_fptr_t readCallBlack, bma4_com_fptr_t writeCallBlack,
              bma4_delay_fptr_t delayCallBlack,
              uint8_t address = BMA4_I2C_ADDR_PRIMARY);
+  // Attach without a soft reset when the sensor still runs the config saved
+  // with saveConfig(signature) before the ESP32 reset; false = call begin()
+  bool resume(bma4_com_fptr_t readCallBlack, bma4_com_fptr_t writeCallBlack,
+              bma4_delay_fptr_t delayCallBlack, uint32_t signature,
+              uint8_t address = BMA4_I2C_ADDR_PRIMARY);
+  void saveConfig(uint32_t signature); // after the feature setup is done
 
   void softReset();
   void shutDown();
@@ -36,6 +49,7 @@ public:
   bool selfTest();
 
   uint8_t getDirection();
+  uint8_t getDirection(const Accel &acc);
 
   bool setAccelConfig(Acfg &cfg);
   bool getAccelConfig(Acfg &cfg);
@@ -66,6 +80,7 @@ public:
   uint32_t getSensorTime();
 
   const char *getActivity();
+  uint8_t getActivityState(); // BMA423_USER_* / BMA423_STATE_INVALID
   bool setRemapAxes(struct bma423_axes_remap *remap_data);
 
   bool enableFeature(uint8_t feature, uint8_t enable);
@@ -75,7 +90,26 @@ public:
   bool enableAnyNoMotionInterrupt(bool en = true);
   bool enableActivityInterrupt(bool en = true);
 
+  bool setAnyNoMotionConfig(uint16_t duration, uint16_t threshold,
+                            bool noMotion);
+  bool enableAnyNoMotionAxis(uint8_t axis = BMA423_ALL_AXIS_EN);
+  bool setInterruptLatch(bool latch = true);
+
+  // Hardware FIFO, headerless accel frames. The watermark is in frames and
+  // downsample divides the ODR by 2^downsample.
+  bool enableFIFO(uint16_t watermark, uint8_t downsample = 0, bool en = true);
+  bool disableFIFO();
+  bool flushFIFO();
+  bool enableFIFOInterrupt(bool en = true);
+  bool isFIFOWatermark();
+  uint16_t getFIFOFrames();
+  uint16_t readFIFO(Accel *samples, uint16_t maxSamples); // frames read
+
 private:
+  void _attach(bma4_com_fptr_t readCallBlack, bma4_com_fptr_t writeCallBlack,
+               bma4_delay_fptr_t delayCallBlack, uint8_t address);
+  uint32_t _signature(uint32_t setup);
+
   bma4_com_fptr_t __readRegisterFptr;
   bma4_com_fptr_t __writeRegisterFptr;
   bma4_delay_fptr_t __delayCallBlackFptr;
@@ -88,12 +88,46 @@
 
 #endif
 
+//i2c
+#define I2C_FREQ 400000 // RTC and BMA423 are both fast mode parts
+#define BMA_SETUP_VERSION 2 // bump when _bmaConfig changes, forces a full init
+//drift calibration (V3 internal RTC)
+#define DRIFT_MIN_SYNC_SEC  43200 // shorter NTP intervals are too coarse
+#define DRIFT_MAX_PPM       500
 //display
 #define DISPLAY_WIDTH 200
 #define DISPLAY_HEIGHT 200
 // wifi
 #define WIFI_AP_TIMEOUT 60
 #define WIFI_AP_SSID    "Watchy AP"
+#define WIFI_FAST_TIMEOUT 1500 // ms, direct association with the cached AP
+#define SYNC_AP_SSID     "Watchy-AP-SYNC"
+#define SYNC_AP_PASS     ""  // 8+ chars for WPA2, empty = open
+#define SYNC_AP_CHANNEL  6
+#define SYNC_AP_MAX_CONN 4   // phone plus a laptop or two
+#define SYNC_AP_BEACON   300 // TU (1.024 ms), default is 100
+#define SYNC_AP_TX_POWER 34  // 0.25 dBm units, 8.5 dBm
+#define SYNC_WS_CLIENTS  3   // live /ws listeners
+#define SYNC_WS_QUEUE    32  // pending cell changes before falling back to a snapshot
+#define SYNC_OTA_TOKEN   ""  // X-OTA-Token for /ota, empty or an open AP = no /ota
+#define SYNC_RECV_TIMEOUTS 3 // recv timeouts in a row (5 s each) before a body upload is dropped
+// motion policy
+#define NO_MOTION_DURATION  7500 // 20 ms samples, ~150 s (BMA423 max is 8191)
+#define ANY_MOTION_DURATION 5    // 100 ms
+#define MOTION_THRESHOLD    0xAA // 83 mg in 5.11g format
+#define MAX_SLEEP_MIN       60   // longest sleep when no ticks are needed
+#define ACCEL_FIFO_DOWN      2  // FIFO gets ODR / 2^n, 100 Hz -> 25 Hz
+#define ACCEL_FIFO_WATERMARK 25 // frames per batch, ~1 s at 25 Hz
+// step history
+#define STEP_LOG_DAYS   7   // hourly entries in RTC memory, at most 10
+#define STEP_FLASH_DAYS 365 // daily totals in NVS
+#define STEP_BACK_HOURS 2   // clock set back by up to this keeps the history (DST, NTP)
+// scheduler
+#define MAX_JOBS 16
+#define NTP_SYNC_INTERVAL  0  // minutes, 0 = off
+#define NTP_SYNC_SLACK     60 // minutes it may run early with another sync
+#define TASK_SYNC_INTERVAL 0  // minutes, 0 = off
+#define TASK_SYNC_SLACK    15
 // menu
 #define WATCHFACE_STATE -1
 #define MAIN_MENU_STATE 0
@@ -101,6 +135,8 @@
 #define FW_UPDATE_STATE 2
 #define MENU_HEIGHT     20
 #define MENU_LENGTH     9
+#define FAST_MENU_TIMEOUT 5000 // ms without a press before going back to deep sleep
+#define BTN_DEBOUNCE_MS   50
 // set time
 #define SET_HOUR   0
 #define SET_MINUTE 1
@@ -116,6 +152,13 @@
 #define SOFTWARE_VERSION_PATCH 0
 #define HARDWARE_VERSION_MAJOR 1
 #define HARDWARE_VERSION_MINOR 0
+#define OTA_MTU                517   // largest ATT MTU, 514 byte writes
+#define OTA_WINDOW             16    // packets the phone may send ahead of an ack
+#define OTA_ACK_EVERY          8     // packets flashed per credit notify
+#define OTA_RING_SIZE          12288 // bytes, holds a full window of max MTU writes
+#define OTA_HTTP_CHUNK         4096  // bytes per esp_ota_write over Wi-Fi
+#define OTA_PROGRESS_STEP      10    // percent between progress bar refreshes
+#define TASK_BLE_SYNC          1     // task table GATT service while Task Times is open
 
 
 #define MARGIN_L   8
@@ -129,6 +172,18 @@
 #define BOT_Y            DISPLAY_HEIGHT - MARGIN_B
 
 
+// task server
+#define TASK_MDNS_SERVICE    "_watchytask"
+#define TASK_MDNS_TIMEOUT    1500            // ms, bounded so a missing server can't hold the radio
+#define TASK_MDNS_TTL        1440            // minutes a resolved address is trusted
+#define TASK_CONNECT_TIMEOUT 2000            // ms
+#define TASK_SERVER_HOST     "192.168.0.111" // used when nothing answers mDNS
+#define TASK_SERVER_PORT     5000
+#define MAX_OPS              32 // task edits waiting for upload
+#define TASK_PUSH_DELAY      5  // minutes from an edit to its upload
+#define TASK_PUSH_RETRY      30 // minutes
+#define TASK_PUSH_SLACK      60 // minutes the upload may join an earlier session
+
 // Task Table
 #define NAME_COL_W       56
 #define VCOLS            4
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+# Merenje OTA-a preko sync AP-a: slika iz server.py (/firmware) ili sa diska
+# (WATCHY_FIRMWARE, kao server.py) ide na /ota, vreme se meri za oba dela.
+#   WATCHY_OTA_TOKEN=... python3 ota_push.py --server http://127.0.0.1:5000
+import argparse
+import hashlib
+import os
+import sys
+import time
+import urllib.error
+import urllib.request
+
+
+def timed(label, size, start):
+    ms = max((time.perf_counter() - start) * 1000, 1)
+    print(f"{label}: {size} B u {ms:.0f} ms, {size / ms:.0f} KB/s")
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--server", help="server.py, npr. http://127.0.0.1:5000")
+    ap.add_argument("--watch", default="http://192.168.4.1:8080")
+    ap.add_argument("--token", default=os.environ.get("WATCHY_OTA_TOKEN", ""))
+    args = ap.parse_args()
+
+    if args.server:
+        start = time.perf_counter()
+        with urllib.request.urlopen(args.server + "/firmware") as resp:
+            image = resp.read()
+            want = resp.headers.get("X-Image-SHA256", "")
+        timed("server.py /firmware", len(image), start)
+    else:
+        path = os.environ.get("WATCHY_FIRMWARE", "firmware.bin")
+        with open(path, "rb") as f:
+            image = f.read()
+        want = ""
+    sha = hashlib.sha256(image).hexdigest()
+    if want and want != sha:
+        sys.exit(f"X-Image-SHA256 {want} ne odgovara slici {sha}")
+
+    req = urllib.request.Request(args.watch + "/ota", data=image, headers={
+        "Content-Type": "application/octet-stream",
+        "X-OTA-Token": args.token,
+        "X-Image-SHA256": sha,
+    })
+    start = time.perf_counter()
+    try:
+        with urllib.request.urlopen(req, timeout=120) as resp:
+            body = resp.read().decode()
+    except urllib.error.HTTPError as e:
+        sys.exit(f"/ota: HTTP {e.code} {e.read().decode()}")
+    timed("/ota", len(image), start)
+    print(body)
+
+
+if __name__ == "__main__":
+    main()
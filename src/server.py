@@ -1,11 +1,91 @@
-from flask import Flask, jsonify
+from flask import Flask, Response, jsonify, request, send_file
+import hashlib
 import json
+import os
+import socket
+import time
+
+PORT = 5000
 
 app = Flask(__name__)
 
 @app.route('/data')
 def get_data():
     with open("task_data.json") as f:
-        return jsonify(json.load(f))
+        body = json.dumps(json.load(f), separators=(",", ":"))
+    # ETag = hash sadržaja, Watchy šalje If-None-Match i dobija 304 ako nema promene
+    response = Response(body, mimetype="application/json")
+    response.set_etag(hashlib.sha1(body.encode()).hexdigest()[:16])
+    return response.make_conditional(request)
+
+
+@app.route('/ops', methods=['POST'])
+def post_ops():
+    # batch izmena sa sata: {"ops": [...]} ili cela tabela {"values": [[...]]}
+    body = request.get_json(force=True)
+    with open("task_data.json") as f:
+        data = json.load(f)
+    if "values" in body:
+        data["values"] = body["values"]
+    values = data["values"]
+    for op in body.get("ops", []):
+        if op["op"] == "add":
+            values[op["r"]][op["c"]] += op["v"]
+        elif op["op"] == "resetRow":
+            values[op["r"]] = [0] * len(values[op["r"]])
+        elif op["op"] == "resetCol":
+            for row in values:
+                row[op["c"]] = 0
+    with open("task_data.json", "w") as f:
+        json.dump(data, f, separators=(",", ":"))
+    return jsonify(status="ok", applied=len(body.get("ops", [])))
+
+
+def file_sha256(path):
+    h = hashlib.sha256()
+    with open(path, "rb") as f:
+        for chunk in iter(lambda: f.read(65536), b""):
+            h.update(chunk)
+    return h.hexdigest()
+
+
+@app.route('/firmware')
+def get_firmware():
+    # Wi-Fi OTA: sat strimuje telo direktno u esp_ota_write
+    path = os.environ.get("WATCHY_FIRMWARE", "firmware.bin")
+    if not os.path.isfile(path):
+        return jsonify(error=f"{path} ne postoji"), 404
+    print(f"OTA: šaljem {path} ({os.path.getsize(path)} B) u {time.strftime('%X')}")
+    response = send_file(path, mimetype="application/octet-stream", conditional=False)
+    # sat proverava sliku pre nego što je aktivira
+    response.headers["X-Image-SHA256"] = file_sha256(path)
+    return response
+
+
+def advertise():
+    # Watchy traži server preko mDNS (_watchytask._tcp), pip install zeroconf
+    try:
+        from zeroconf import ServiceInfo, Zeroconf
+    except ImportError:
+        print("zeroconf nije instaliran – Watchy koristi TASK_SERVER_HOST")
+        return None
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.connect(("8.8.8.8", 80))  # samo da saznamo IP na LAN-u
+    ip = s.getsockname()[0]
+    s.close()
+    info = ServiceInfo("_watchytask._tcp.local.",
+                       "Watchy task server._watchytask._tcp.local.",
+                       addresses=[socket.inet_aton(ip)], port=PORT)
+    zc = Zeroconf()
+    zc.register_service(info)
+    print(f"mDNS: _watchytask._tcp na {ip}:{PORT}")
+    return zc
+
 
-app.run(host="0.0.0.0", port=5000)
+zc = advertise()
+try:
+    app.run(host="0.0.0.0", port=PORT)
+finally:
+    if zc:
+        zc.unregister_all_services()
+        zc.close()
@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+# Opterećenje sync AP-a: paralelni klijenti na /state i /push, latencije po
+# endpoint-u. Pokreće se sa računara povezanog na Watchy-AP-SYNC:
+#   python3 sync_load.py --clients 4 --requests 50
+# ili bez sata, protiv lokalne zamene za httpd handlere (isti odgovori, jedan
+# httpd task, red od MAX_OPS izmena koji AP petlja prazni na 50 ms):
+#   python3 sync_load.py --local
+import argparse
+import http.server
+import json
+import queue
+import random
+import threading
+import time
+import urllib.error
+import urllib.request
+
+MAX_OPS = 32          # config.h, kapacitet pushOps reda
+PUSH_MAX_BODY = 2048  # syncPushHandler
+AP_LOOP_MS = 50       # delay(50) u AP petlji taskTimes-a
+COMPONENTS = ["Hrdwr", "Sftwr", "Frmwr"]
+TASKS = ["Task1", "Task2", "Task3", "Rbt"]
+
+
+class LocalWatch:
+    """Tabela, pushOps red i op log kao na satu."""
+
+    def __init__(self, rows, cols):
+        self.values = [[0] * cols for _ in range(rows)]
+        self.lock = threading.Lock()  # lockTable()
+        self.ops = queue.Queue(MAX_OPS)
+        self.log = []  # taskLog.add posle _logSyncPush
+        self.stop = threading.Event()
+
+    def state(self):
+        # snapshot pod lock-om, serijalizacija bez njega (tableJson)
+        with self.lock:
+            values = [row[:] for row in self.values]
+        rows, cols = len(values), len(values[0])
+        return json.dumps({
+            "numComponents": rows, "numTasks": cols,
+            "componentNames": (COMPONENTS + [f"C{i}" for i in range(rows)])[:rows],
+            "taskNames": (TASKS + [f"T{j}" for j in range(cols)])[:cols],
+            "values": values})
+
+    def push(self, body):
+        try:
+            doc = json.loads(body)
+        except ValueError:
+            return 400, {"error": "bad json"}
+        if not isinstance(doc, dict) or "updates" not in doc:
+            return 400, {"error": "no updates"}
+        updates = doc["updates"]
+        # ceo zahtev ili ništa
+        if MAX_OPS - self.ops.qsize() < len(updates):
+            return 503, {"error": "busy"}
+        with self.lock:
+            for u in updates:
+                r, c, v = u.get("r", -1), u.get("c", -1), u.get("v", 0)
+                if 0 <= r < len(self.values) and 0 <= c < len(self.values[0]):
+                    delta = max(-32768, min(32767, v - self.values[r][c]))
+                    if delta == 0:
+                        continue
+                    self.values[r][c] += delta
+                    self.ops.put_nowait((r, c, delta))
+        return 200, {"status": "ok"}
+
+    def drain(self):
+        while not self.stop.is_set():
+            self.stop.wait(AP_LOOP_MS / 1000)
+            self.drain_once()
+
+    def drain_once(self):
+        while True:
+            try:
+                self.log.append(self.ops.get_nowait())
+            except queue.Empty:
+                return
+
+    def check_log(self):
+        # server dobija samo log: zbir delta mora da da tabelu
+        rows, cols = len(self.values), len(self.values[0])
+        logged = [[0] * cols for _ in range(rows)]
+        for r, c, delta in self.log:
+            logged[r][c] += delta
+        return logged == self.values
+
+
+def serve_local(watch):
+    class Handler(http.server.BaseHTTPRequestHandler):
+        def send(self, status, body):
+            data = body.encode() if isinstance(body, str) else json.dumps(body).encode()
+            self.send_response(status)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(data)))
+            self.end_headers()
+            self.wfile.write(data)
+
+        def do_GET(self):
+            if self.path == "/state":
+                self.send(200, watch.state())
+            else:
+                self.send(404, {"error": "not found"})
+
+        def do_POST(self):
+            if self.path != "/push":
+                self.send(404, {"error": "not found"})
+                return
+            n = int(self.headers.get("Content-Length", 0))
+            if n == 0 or n > PUSH_MAX_BODY:
+                self.send(400, {"error": "no payload"})
+                return
+            self.send(*watch.push(self.rfile.read(n)))
+
+        def log_message(self, *args):
+            pass
+
+    # HTTPServer bez niti: jedan zahtev u isto vreme, kao jedini httpd task
+    server = http.server.HTTPServer(("127.0.0.1", 0), Handler)
+    server.request_queue_size = 4  # max_open_sockets
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    threading.Thread(target=watch.drain, daemon=True).start()
+    return server
+
+
+def request(url, body=None):
+    data = None if body is None else json.dumps(body).encode()
+    req = urllib.request.Request(url, data=data,
+                                 headers={"Content-Type": "application/json"})
+    start = time.perf_counter()
+    try:
+        with urllib.request.urlopen(req, timeout=10) as resp:
+            resp.read()
+            status = resp.status
+    except urllib.error.HTTPError as e:
+        status = e.code
+    except OSError:
+        status = None  # veza odbijena ili timeout
+    return status, (time.perf_counter() - start) * 1000
+
+
+def client(base, n, rows, cols, results, lock):
+    for i in range(n):
+        if i % 2 == 0:
+            name, (status, ms) = "/state", request(base + "/state")
+        else:
+            # vrednosti su apsolutne, sat računa delta za log
+            updates = [{"r": random.randrange(rows), "c": random.randrange(cols),
+                        "v": random.randrange(600)} for _ in range(3)]
+            name, (status, ms) = "/push", request(base + "/push",
+                                                  {"updates": updates})
+        with lock:
+            results.setdefault(name, []).append((status, ms))
+
+
+def percentile(sorted_ms, p):
+    return sorted_ms[min(len(sorted_ms) - 1, int(len(sorted_ms) * p))]
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--host", default="192.168.4.1")
+    ap.add_argument("--port", type=int, default=8080)
+    ap.add_argument("--clients", type=int, default=4)  # SYNC_AP_MAX_CONN
+    ap.add_argument("--requests", type=int, default=50)  # po klijentu
+    ap.add_argument("--rows", type=int, default=3)
+    ap.add_argument("--cols", type=int, default=4)
+    ap.add_argument("--local", action="store_true",
+                    help="lokalna zamena za handlere umesto sata")
+    args = ap.parse_args()
+
+    watch = None
+    if args.local:
+        watch = LocalWatch(args.rows, args.cols)
+        server = serve_local(watch)
+        args.host, args.port = server.server_address
+    base = f"http://{args.host}:{args.port}"
+    results, lock = {}, threading.Lock()
+    threads = [threading.Thread(target=client,
+                                args=(base, args.requests, args.rows,
+                                      args.cols, results, lock))
+               for _ in range(args.clients)]
+    start = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    wall = time.perf_counter() - start
+
+    total = sum(len(r) for r in results.values())
+    print(f"{total} zahteva, {args.clients} klijenata, {wall:.1f} s, "
+          f"{total / wall:.1f} req/s")
+    for name, rows in sorted(results.items()):
+        ok = sorted(ms for status, ms in rows if status == 200)
+        codes = {}
+        for status, _ in rows:
+            codes[status] = codes.get(status, 0) + 1
+        line = f"{name:7} ok {len(ok)}/{len(rows)} {codes}"
+        if ok:
+            line += (f"  p50 {percentile(ok, 0.5):.0f} ms"
+                     f"  p95 {percentile(ok, 0.95):.0f} ms"
+                     f"  max {ok[-1]:.0f} ms")
+        print(line)
+
+    if watch is not None:
+        watch.stop.set()
+        watch.drain_once()  # stopSyncAP prazni red još jednom
+        ok = watch.check_log()
+        print(f"op log: {len(watch.log)} izmena, "
+              f"{'odgovara tabeli' if ok else 'NE ODGOVARA tabeli'}")
+        return 0 if ok else 1
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,85 @@
+import os
+import re
+import sys
+import zoneinfo
+
+# Zone-ovi koji se kompajliraju u tz_rules.h (prosledi druge kao argumente)
+DEFAULT_ZONES = [
+    "UTC",
+    "Europe/Belgrade",
+    "Europe/London",
+    "Europe/Berlin",
+    "Europe/Moscow",
+    "America/New_York",
+    "America/Chicago",
+    "America/Denver",
+    "America/Los_Angeles",
+    "Asia/Tokyo",
+    "Asia/Kolkata",
+    "Australia/Sydney",
+]
+
+NAME = r"(?:<[^>]+>|[A-Za-z]+)"
+OFFSET = r"[+-]?\d+(?::\d+){0,2}"
+RULE = r"M(\d+)\.(\d)\.(\d)(?:/(" + OFFSET + r"))?"
+POSIX_TZ = re.compile(
+    rf"^{NAME}({OFFSET})(?:{NAME}({OFFSET})?,{RULE},{RULE})?$")
+
+
+def minutes(hms, default=0):
+    # "-1", "2:30", "+5" -> minutes
+    if hms is None:
+        return default
+    sign = -1 if hms.startswith("-") else 1
+    parts = [int(p) for p in hms.lstrip("+-").split(":")] + [0, 0]
+    return sign * (parts[0] * 60 + parts[1])
+
+
+def posix_footer(zone):
+    # TZif v2+ fajlovi se završavaju sa "\n<POSIX TZ>\n"
+    for base in zoneinfo.TZPATH:
+        path = os.path.join(base, zone)
+        if os.path.isfile(path):
+            with open(path, "rb") as f:
+                return f.read().rstrip(b"\n").rsplit(b"\n", 1)[1].decode()
+    raise SystemExit(f"nepoznat zone: {zone}")
+
+
+def rule_for(zone):
+    tz = posix_footer(zone)
+    m = POSIX_TZ.match(tz)
+    if not m:
+        raise SystemExit(f"{zone}: nepodržan POSIX TZ '{tz}'")
+    std = -minutes(m.group(1))  # POSIX: zapad je pozitivan
+    if m.group(3) is None:
+        return (zone, std, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+    dst = -minutes(m.group(2), -(std + 60)) - std
+    return (zone, std, dst,
+            int(m.group(3)), int(m.group(4)), int(m.group(5)),
+            minutes(m.group(6), 120),
+            int(m.group(7)), int(m.group(8)), int(m.group(9)),
+            minutes(m.group(10), 120))
+
+
+def save_rules_as_header(rules, filename="tz_rules.h"):
+    version = "unknown"
+    for base in zoneinfo.TZPATH:
+        zi = os.path.join(base, "tzdata.zi")
+        if os.path.isfile(zi):
+            with open(zi) as f:
+                version = f.readline().split()[-1]
+            break
+    with open(filename, "w") as f:
+        f.write(f"// Auto-generated by tz_gen.py from tzdata {version}\n\n")
+        f.write("#pragma once\n\n")
+        f.write('#include "WatchyTZ.h"\n\n')
+        f.write("// name, std, dst delta (min), start M.w.d/min, end M.w.d/min\n")
+        f.write("const tzRule tzRules[] = {\n")
+        for r in rules:
+            f.write('    {"%s", %d, %d, %d, %d, %d, %d, %d, %d, %d, %d},\n' % r)
+        f.write("};\n")
+
+
+zones = sys.argv[1:] or DEFAULT_ZONES
+save_rules_as_header([rule_for(z) for z in zones])
+print(f"tz_rules.h generisan za {len(zones)} zona")
@@ -0,0 +1,21 @@
+// Auto-generated by tz_gen.py from tzdata 2025b
+
+#pragma once
+
+#include "WatchyTZ.h"
+
+// name, std, dst delta (min), start M.w.d/min, end M.w.d/min
+const tzRule tzRules[] = {
+    {"UTC", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Europe/Belgrade", 60, 60, 3, 5, 0, 120, 10, 5, 0, 180},
+    {"Europe/London", 0, 60, 3, 5, 0, 60, 10, 5, 0, 120},
+    {"Europe/Berlin", 60, 60, 3, 5, 0, 120, 10, 5, 0, 180},
+    {"Europe/Moscow", 180, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"America/New_York", -300, 60, 3, 2, 0, 120, 11, 1, 0, 120},
+    {"America/Chicago", -360, 60, 3, 2, 0, 120, 11, 1, 0, 120},
+    {"America/Denver", -420, 60, 3, 2, 0, 120, 11, 1, 0, 120},
+    {"America/Los_Angeles", -480, 60, 3, 2, 0, 120, 11, 1, 0, 120},
+    {"Asia/Tokyo", 540, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Asia/Kolkata", 330, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {"Australia/Sydney", 600, 60, 10, 1, 0, 120, 4, 1, 0, 180},
+};
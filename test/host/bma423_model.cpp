@@ -0,0 +1,196 @@
+#include "bma423_model.h"
+
+extern "C" const uint8_t bma423_config_file[];
+
+void BMA423Model::powerCycle() {
+  memset(config, 0, sizeof(config));
+  memset(features, 0, sizeof(features));
+  softReset();
+  softResets = 0;
+  _nackUntil = 0;
+}
+
+void BMA423Model::softReset() {
+  // the config RAM does not survive a soft reset either
+  memset(regs, 0, sizeof(regs));
+  regs[0x00] = 0x13; // CHIP_ID
+  regs[0x40] = 0xA8; // ACC_CONF
+  regs[0x41] = 0x11; // ACC_RANGE
+  regs[0x45] = 0x88; // FIFO_DOWNS
+  regs[0x46] = 0x88; // FIFO_WTM_0
+  regs[0x47] = 0x02; // FIFO_WTM_1
+  regs[0x48] = 0x02; // FIFO_CONFIG_0
+  regs[0x49] = 0x10; // FIFO_CONFIG_1, header on
+  regs[0x7C] = 0x03; // PWR_CONF, APS on
+  _loaded    = false;
+  _readyAt   = 0;
+  _fifoLen   = 0;
+  _ptr       = 0;
+  _nackUntil = hostMicros() + RESET_US;
+  softResets++;
+  _updateFifoRegs();
+}
+
+bool BMA423Model::initialized() const {
+  return _loaded && hostMicros() >= _readyAt;
+}
+
+void BMA423Model::pushFrame(int16_t x, int16_t y, int16_t z) {
+  int16_t v[3] = {x, y, z};
+  if (_fifoLen + 6 > FIFO_SIZE) return; // stop-on-full is off: drop newest
+  for (int i = 0; i < 3; i++) {
+    uint16_t raw         = (uint16_t)(v[i] << 4);
+    _fifo[_fifoLen++] = raw & 0xFF;
+    _fifo[_fifoLen++] = raw >> 8;
+  }
+  _updateFifoRegs();
+}
+
+void BMA423Model::dropFrames(uint16_t n) {
+  uint16_t bytes = min((uint16_t)(n * 6), _fifoLen);
+  memmove(_fifo, _fifo + bytes, _fifoLen - bytes);
+  _fifoLen -= bytes;
+  _updateFifoRegs();
+}
+
+void BMA423Model::setSteps(uint32_t steps) {
+  for (int i = 0; i < 4; i++) {
+    regs[0x1E + i] = steps >> (8 * i);
+  }
+}
+
+void BMA423Model::_setAsic(uint16_t word) {
+  regs[0x5B] = word & 0x0F;
+  regs[0x5C] = word >> 4;
+}
+
+void BMA423Model::_updateFifoRegs() {
+  regs[0x24]     = _fifoLen & 0xFF;
+  regs[0x25]     = (_fifoLen >> 8) & 0x3F;
+  uint16_t wm    = regs[0x46] | regs[0x47] << 8;
+  bool enabled   = regs[0x49] & 0x40; // accel frames into the FIFO
+  if (enabled && wm > 0 && _fifoLen >= wm) {
+    regs[0x1D] |= 0x02; // fifo_wm, latched until read
+  }
+}
+
+bool BMA423Model::i2cWrite(const uint8_t *data, size_t len) {
+  if (hostMicros() < _nackUntil) {
+    nacks++;
+    return false;
+  }
+  if (len == 0) return true;
+  _ptr = data[0];
+  if (len == 1) return true; // register pointer for the next read
+
+  if (_ptr == 0x5E) {
+    // burst into the ASIC memory: one address, no register auto-increment
+    if (apsEnabled()) {
+      apsViolations++;
+      return true; // the sensor ignores it while it may be suspended
+    }
+    if (!_loaded) {
+      uint32_t at = _asic() * 2;
+      for (size_t i = 1; i < len && at < CONFIG_SIZE; i++) {
+        config[at++] = data[i];
+      }
+      configWrites++;
+    } else {
+      for (size_t i = 1; i < len && i - 1 < FEATURE_SIZE; i++) {
+        features[i - 1] = data[i];
+      }
+      featureWrites++;
+    }
+    return true;
+  }
+  for (size_t i = 1; i < len; i++) {
+    _writeReg(_ptr++, data[i]);
+  }
+  return true;
+}
+
+void BMA423Model::_writeReg(uint8_t reg, uint8_t value) {
+  reg &= 0x7F;
+  switch (reg) {
+  case 0x7E: // CMD
+    if (value == 0xB6) {
+      softReset();
+    } else if (value == 0xB0) {
+      _fifoLen = 0;
+      _updateFifoRegs();
+    }
+    return;
+  case 0x59: // INIT_CTRL
+    regs[reg] = value;
+    if (value == 0x01 && !_loaded) {
+      // the sensor checks the stream; loading with APS on never finishes
+      if (!apsEnabled() &&
+          memcmp(config, bma423_config_file, CONFIG_SIZE) == 0) {
+        _loaded  = true;
+        _readyAt = hostMicros() + INIT_US;
+        _setAsic(FEATURE_START);
+      }
+    }
+    return;
+  case 0x00: // read only
+  case 0x1C:
+  case 0x1D:
+  case 0x24:
+  case 0x25:
+  case 0x2A:
+    return;
+  default:
+    regs[reg] = value;
+    if (reg == 0x46 || reg == 0x47 || reg == 0x49) _updateFifoRegs();
+    return;
+  }
+}
+
+bool BMA423Model::i2cRead(uint8_t *data, size_t len) {
+  if (hostMicros() < _nackUntil) {
+    nacks++;
+    return false;
+  }
+  if (_ptr == 0x26) {
+    // FIFO_DATA keeps the pointer; a frame read only in part is sent again
+    fifoReads++;
+    size_t n = min(len, (size_t)_fifoLen);
+    memcpy(data, _fifo, n);
+    for (size_t i = n; i < len; i++) {
+      data[i] = ((i - n) % 2) == 0 ? 0x80 : 0x00; // empty frame marker
+      fifoOverReads++;
+    }
+    size_t used = n - n % 6;
+    memmove(_fifo, _fifo + used, _fifoLen - used);
+    _fifoLen -= used;
+    _updateFifoRegs();
+    return true;
+  }
+  if (_ptr == 0x5E) {
+    for (size_t i = 0; i < len; i++) {
+      data[i] = (_loaded && i < FEATURE_SIZE) ? features[i] : 0;
+    }
+    return true;
+  }
+  for (size_t i = 0; i < len; i++) {
+    data[i] = _readReg(_ptr++);
+  }
+  return true;
+}
+
+uint8_t BMA423Model::_readReg(uint8_t reg) {
+  reg &= 0x7F;
+  uint8_t v = regs[reg];
+  switch (reg) {
+  case 0x1C: // INT_STATUS_0/1 clear on read
+  case 0x1D:
+    regs[reg] = 0;
+    break;
+  case 0x2A:
+    v = initialized() ? 0x01 : 0x00;
+    break;
+  default:
+    break;
+  }
+  return v;
+}
@@ -0,0 +1,60 @@
+// BMA423 register file behind the host Wire: soft reset, the config stream
+// load (INIT_CTRL, ASIC address, INTERNAL_STAT), the 64 byte feature page,
+// a headerless accel FIFO on 0x26 and the FIFO watermark interrupt.
+#pragma once
+
+#include <Wire.h>
+
+class BMA423Model : public I2CDevice {
+public:
+  static const uint8_t ADDRESS        = 0x18;
+  static const uint32_t RESET_US      = 2000;   // NACK after a soft reset
+  static const uint32_t INIT_US       = 140000; // config load to INTERNAL_STAT
+  static const uint16_t CONFIG_SIZE   = 6144;
+  static const uint16_t FEATURE_SIZE  = 64;
+  static const uint16_t FEATURE_START = 0x180; // ASIC word address after init
+  static const uint16_t FIFO_SIZE     = 1024;
+
+  BMA423Model() { powerCycle(); }
+  void attach() { Wire.attach(ADDRESS, this); }
+  void powerCycle(); // power-on defaults, config and FIFO lost
+  void softReset();
+
+  bool initialized() const; // INTERNAL_STAT reads 0x01
+  bool apsEnabled() const { return regs[0x7C] & 0x01; }
+
+  // headerless accel frame: three 12 bit values, left aligned, LSB first
+  void pushFrame(int16_t x, int16_t y, int16_t z);
+  uint16_t fifoBytes() const { return _fifoLen; }
+  void dropFrames(uint16_t n); // oldest first, as a flush would
+  void setSteps(uint32_t steps);
+
+  bool i2cWrite(const uint8_t *data, size_t len) override;
+  bool i2cRead(uint8_t *data, size_t len) override;
+
+  uint8_t regs[128];
+  uint8_t config[CONFIG_SIZE];
+  uint8_t features[FEATURE_SIZE];
+
+  uint32_t softResets    = 0;
+  uint32_t configWrites  = 0; // 0x5E bursts while loading
+  uint32_t featureWrites = 0; // 0x5E bursts once initialized
+  uint32_t apsViolations = 0; // 0x5E bursts with advanced power save on
+  uint32_t fifoReads     = 0; // read transactions on 0x26
+  uint32_t fifoOverReads = 0; // bytes read past the end of the FIFO
+  uint32_t nacks         = 0;
+
+private:
+  uint16_t _asic() const { return (regs[0x5C] << 4) | (regs[0x5B] & 0x0F); }
+  void _setAsic(uint16_t word);
+  void _writeReg(uint8_t reg, uint8_t value);
+  uint8_t _readReg(uint8_t reg);
+  void _updateFifoRegs();
+
+  uint8_t _ptr            = 0;
+  bool _loaded            = false; // config stream accepted
+  uint64_t _readyAt       = 0;     // INTERNAL_STAT goes to 0x01
+  uint64_t _nackUntil     = 0;
+  uint8_t _fifo[FIFO_SIZE];
+  uint16_t _fifoLen       = 0;
+};
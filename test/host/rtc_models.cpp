@@ -0,0 +1,123 @@
+#include "rtc_models.h"
+
+static uint8_t dec2bcd(uint8_t v) { return ((v / 10) << 4) | (v % 10); }
+static uint8_t bcd2dec(uint8_t v) { return (v >> 4) * 10 + (v & 0x0F); }
+
+void RtcModel::setTime(time_t t) {
+  _base   = t;
+  _baseUs = hostMicros();
+}
+
+time_t RtcModel::now() const {
+  return _base + (time_t)((hostMicros() - _baseUs) / 1000000);
+}
+
+bool RtcModel::i2cWrite(const uint8_t *data, size_t len) {
+  if (len == 0) return true; // probe
+  _ptr         = data[0];
+  uint8_t sec  = _secondsReg();
+  bool setTime = false;
+  for (size_t i = 1; i < len; i++, _ptr++) {
+    if (_ptr >= sec && _ptr < sec + 7) {
+      // time registers are latched in a buffer, the count restarts on write
+      if (!setTime) {
+        tmElements_t tm;
+        breakTime(now(), tm);
+        _timeToRegs(tm);
+      }
+      regs[_ptr] = data[i];
+      setTime    = true;
+    } else {
+      _writeReg(_ptr % sizeof(regs), data[i]);
+    }
+  }
+  if (setTime) {
+    tmElements_t tm;
+    _regsToTime(tm);
+    this->setTime(makeTime(tm));
+  }
+  return true;
+}
+
+bool RtcModel::i2cRead(uint8_t *data, size_t len) {
+  uint8_t sec = _secondsReg();
+  if (_ptr < sec + 7 && _ptr + len > sec) {
+    timeReads++;
+  }
+  tmElements_t tm;
+  breakTime(now(), tm);
+  _timeToRegs(tm);
+  for (size_t i = 0; i < len; i++) {
+    data[i] = regs[(_ptr++) % sizeof(regs)];
+  }
+  return true;
+}
+
+DS3231Model::DS3231Model() {
+  regs[0x0E] = 0x1C; // INTCN, RS2, RS1
+  regs[0x0F] = 0x88; // OSF and EN32kHz after first power
+}
+
+void DS3231Model::_timeToRegs(const tmElements_t &tm) {
+  regs[0x00] = dec2bcd(tm.Second);
+  regs[0x01] = dec2bcd(tm.Minute);
+  regs[0x02] = dec2bcd(tm.Hour);
+  regs[0x03] = tm.Wday;
+  regs[0x04] = dec2bcd(tm.Day);
+  regs[0x05] = dec2bcd(tm.Month);
+  regs[0x06] = dec2bcd(tmYearToY2k(tm.Year));
+}
+
+void DS3231Model::_regsToTime(tmElements_t &tm) {
+  tm.Second = bcd2dec(regs[0x00] & 0x7F);
+  tm.Minute = bcd2dec(regs[0x01]);
+  tm.Hour   = bcd2dec(regs[0x02] & 0x3F);
+  tm.Day    = bcd2dec(regs[0x04]);
+  tm.Month  = bcd2dec(regs[0x05] & 0x1F);
+  tm.Year   = y2kYearToTm(bcd2dec(regs[0x06]));
+}
+
+void DS3231Model::_writeReg(uint8_t reg, uint8_t value) {
+  if (reg == 0x0F) {
+    // OSF, A2F, A1F can only be cleared; EN32kHz is plain
+    uint8_t flags = 0x83;
+    regs[reg]     = (regs[reg] & flags & value) | (value & ~flags & 0x08);
+    return;
+  }
+  if (reg == 0x11 || reg == 0x12) return; // temperature, read only
+  regs[reg] = value;
+}
+
+PCF8563Model::PCF8563Model() {
+  regs[0x02] = 0x80; // VL: clock integrity not guaranteed
+  regs[0x09] = regs[0x0A] = regs[0x0B] = regs[0x0C] = 0x80; // alarms off
+}
+
+void PCF8563Model::_timeToRegs(const tmElements_t &tm) {
+  regs[0x02] = (regs[0x02] & 0x80) | dec2bcd(tm.Second);
+  regs[0x03] = dec2bcd(tm.Minute);
+  regs[0x04] = dec2bcd(tm.Hour);
+  regs[0x05] = dec2bcd(tm.Day);
+  regs[0x06] = tm.Wday - 1;
+  regs[0x07] = dec2bcd(tm.Month);
+  regs[0x08] = dec2bcd(tmYearToY2k(tm.Year));
+}
+
+void PCF8563Model::_regsToTime(tmElements_t &tm) {
+  tm.Second = bcd2dec(regs[0x02] & 0x7F);
+  tm.Minute = bcd2dec(regs[0x03] & 0x7F);
+  tm.Hour   = bcd2dec(regs[0x04] & 0x3F);
+  tm.Day    = bcd2dec(regs[0x05] & 0x3F);
+  tm.Month  = bcd2dec(regs[0x07] & 0x1F);
+  tm.Year   = y2kYearToTm(bcd2dec(regs[0x08]));
+}
+
+void PCF8563Model::_writeReg(uint8_t reg, uint8_t value) {
+  if (reg == 0x01) {
+    // AF and TF are cleared by writing 0, a 1 leaves them
+    uint8_t flags = 0x0C;
+    regs[reg]     = (regs[reg] & flags & value) | (value & ~flags & 0x13);
+    return;
+  }
+  regs[reg] = value;
+}
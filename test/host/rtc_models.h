@@ -0,0 +1,58 @@
+// DS3231 and PCF8563 register files behind the host Wire. Both keep time
+// from the host clock, so the seconds registers move as the test advances.
+#pragma once
+
+#include <Wire.h>
+#include <TimeLib.h>
+
+class RtcModel : public I2CDevice {
+public:
+  void setTime(time_t t); // chip time
+  time_t now() const;
+
+  bool i2cWrite(const uint8_t *data, size_t len) override;
+  bool i2cRead(uint8_t *data, size_t len) override;
+
+  uint8_t regs[32] = {};
+  uint32_t timeReads = 0; // read transactions touching the time registers
+
+protected:
+  virtual uint8_t _secondsReg() const = 0;
+  virtual void _timeToRegs(const tmElements_t &tm) = 0;
+  virtual void _regsToTime(tmElements_t &tm) = 0;
+  virtual void _writeReg(uint8_t reg, uint8_t value) { regs[reg] = value; }
+
+  uint8_t _ptr     = 0;
+  time_t _base     = 0;
+  uint64_t _baseUs = 0;
+};
+
+class DS3231Model : public RtcModel {
+public:
+  static const uint8_t ADDRESS = 0x68;
+  DS3231Model();
+  void attach() { Wire.attach(ADDRESS, this); }
+  void powerLoss() { regs[0x0F] |= 0x80; } // OSF: time may be wrong
+  void alarm2() { regs[0x0F] |= 0x02; }    // A2F
+  uint8_t status() const { return regs[0x0F]; }
+
+protected:
+  uint8_t _secondsReg() const override { return 0x00; }
+  void _timeToRegs(const tmElements_t &tm) override;
+  void _regsToTime(tmElements_t &tm) override;
+  void _writeReg(uint8_t reg, uint8_t value) override;
+};
+
+class PCF8563Model : public RtcModel {
+public:
+  static const uint8_t ADDRESS = 0x51;
+  PCF8563Model();
+  void attach() { Wire.attach(ADDRESS, this); }
+  void alarm() { regs[0x01] |= 0x08; } // AF
+
+protected:
+  uint8_t _secondsReg() const override { return 0x02; }
+  void _timeToRegs(const tmElements_t &tm) override;
+  void _regsToTime(tmElements_t &tm) override;
+  void _writeReg(uint8_t reg, uint8_t value) override;
+};
@@ -0,0 +1,115 @@
+#include "Arduino.h"
+#include <stdarg.h>
+#include "driver/gpio.h"
+
+#define HOST_PINS 64
+
+HardwareSerial Serial;
+
+static uint64_t nowUs = 0;
+static bool verbose   = false;
+static int pinModes[HOST_PINS];
+static int pinLevels[HOST_PINS];
+static hostReadHook readHooks[HOST_PINS];
+static hostWriteHook writeHooks[HOST_PINS];
+static hostSleepHook sleepHook = NULL;
+static uint32_t lightSleeps    = 0;
+
+// bounds of the RTC memory sections, from the linker
+extern char __start_rtc_data[] __attribute__((weak));
+extern char __stop_rtc_data[] __attribute__((weak));
+extern char __start_rtc_noinit[] __attribute__((weak));
+extern char __stop_rtc_noinit[] __attribute__((weak));
+
+static char *rtcDataImage = NULL; // initial values, as in the flash image
+
+__attribute__((constructor)) static void saveRtcDataImage() {
+  size_t len   = __stop_rtc_data - __start_rtc_data;
+  rtcDataImage = (char *)malloc(len ? len : 1);
+  if (len) memcpy(rtcDataImage, __start_rtc_data, len);
+}
+
+unsigned long millis() { return (unsigned long)(nowUs / 1000); }
+unsigned long micros() { return (unsigned long)nowUs; }
+void delay(uint32_t ms) { nowUs += (uint64_t)ms * 1000; }
+void delayMicroseconds(uint32_t us) { nowUs += us; }
+void yield() {}
+
+void pinMode(int pin, int mode) {
+  if (pin < 0 || pin >= HOST_PINS) return;
+  pinModes[pin] = mode;
+  if (mode == INPUT_PULLUP) {
+    digitalWrite(pin, HIGH); // released, the pull-up takes the line high
+  }
+}
+
+void digitalWrite(int pin, int level) {
+  if (pin < 0 || pin >= HOST_PINS) return;
+  pinLevels[pin] = level;
+  if (writeHooks[pin]) writeHooks[pin](pin, level);
+}
+
+int digitalRead(int pin) {
+  if (pin < 0 || pin >= HOST_PINS) return LOW;
+  return readHooks[pin] ? readHooks[pin](pin) : pinLevels[pin];
+}
+
+int HardwareSerial::printf(const char *fmt, ...) {
+  if (!verbose) return 0;
+  va_list args;
+  va_start(args, fmt);
+  int n = vprintf(fmt, args);
+  va_end(args);
+  return n;
+}
+
+void HardwareSerial::println(const char *s) {
+  if (verbose) puts(s);
+}
+
+void HardwareSerial::print(const char *s) {
+  if (verbose) fputs(s, stdout);
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t, gpio_int_type_t) { return ESP_OK; }
+esp_err_t esp_sleep_enable_gpio_wakeup() { return ESP_OK; }
+
+esp_err_t esp_light_sleep_start() {
+  lightSleeps++;
+  if (sleepHook) sleepHook();
+  return ESP_OK;
+}
+
+uint64_t hostMicros() { return nowUs; }
+void hostAdvance(uint64_t us) { nowUs += us; }
+void hostVerbose(bool on) { verbose = on; }
+
+void hostBoot() {
+  size_t len = __stop_rtc_data - __start_rtc_data;
+  if (len) memcpy(__start_rtc_data, rtcDataImage, len);
+}
+
+void hostPowerOn() {
+  hostBoot();
+  for (char *p = __start_rtc_noinit; p < __stop_rtc_noinit; p++) {
+    *p = (char)rand();
+  }
+}
+
+void hostReset() {
+  nowUs = 0;
+  memset(pinModes, 0, sizeof(pinModes));
+  memset(pinLevels, 0, sizeof(pinLevels));
+  memset(readHooks, 0, sizeof(readHooks));
+  memset(writeHooks, 0, sizeof(writeHooks));
+  sleepHook   = NULL;
+  lightSleeps = 0;
+}
+
+void hostPinReadHook(int pin, hostReadHook hook) { readHooks[pin] = hook; }
+void hostPinWriteHook(int pin, hostWriteHook hook) { writeHooks[pin] = hook; }
+int hostPinMode(int pin) { return pinModes[pin]; }
+int hostPinLevel(int pin) { return pinLevels[pin]; }
+
+void hostLightSleepHook(hostSleepHook hook) { sleepHook = hook; }
+uint32_t hostLightSleeps() { return lightSleeps; }
@@ -0,0 +1,76 @@
+// Host stand-in for the parts of the ESP32 Arduino core the drivers use.
+// Time only moves when the code under test waits, so BUSY and config load
+// timing are deterministic.
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "esp_sleep.h"
+#include "WString.h"
+
+// RTC memory: each kind in its own section so hostBoot()/hostPowerOn() can
+// treat them the way the ESP32 bootloader does
+#define RTC_DATA_ATTR   __attribute__((section("rtc_data"), used))
+#define RTC_NOINIT_ATTR __attribute__((section("rtc_noinit"), used))
+
+#define LOW          0
+#define HIGH         1
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+typedef uint8_t byte;
+
+using std::max;
+using std::min;
+
+#ifndef constrain
+#define constrain(amt, low, high)                                              \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int level);
+int digitalRead(int pin);
+
+class HardwareSerial {
+public:
+  void begin(unsigned long) {}
+  int printf(const char *fmt, ...);
+  void println(const char *s = "");
+  void print(const char *s);
+};
+extern HardwareSerial Serial;
+
+// --- host side: clock and pins, driven by the tests and the models ---
+uint64_t hostMicros();
+void hostAdvance(uint64_t us);
+void hostReset(); // clock to 0, pins and hooks cleared, Serial quiet again
+// reset that is not a deep sleep wake: RTC_DATA_ATTR back to its initial
+// values, RTC_NOINIT_ATTR kept
+void hostBoot();
+void hostPowerOn(); // as hostBoot(), and RTC_NOINIT_ATTR filled with garbage
+void hostVerbose(bool on); // echo Serial output
+
+typedef int (*hostReadHook)(int pin);
+typedef void (*hostWriteHook)(int pin, int level);
+void hostPinReadHook(int pin, hostReadHook hook);
+void hostPinWriteHook(int pin, hostWriteHook hook);
+int hostPinMode(int pin);
+int hostPinLevel(int pin);
+
+// esp_light_sleep_start() calls this; 0 = sleep returns at once
+typedef void (*hostSleepHook)();
+void hostLightSleepHook(hostSleepHook hook);
+uint32_t hostLightSleeps();
@@ -0,0 +1,93 @@
+#include "DS3232RTC.h"
+
+static uint8_t dec2bcd(uint8_t n) { return n + 6 * (n / 10); }
+static uint8_t bcd2dec(uint8_t n) { return n - 6 * (n >> 4); }
+
+uint8_t DS3232RTC::read(tmElements_t &tm) {
+  _wire.beginTransmission(0x68);
+  _wire.write((uint8_t)0x00);
+  if (uint8_t e = _wire.endTransmission()) return e;
+  _wire.requestFrom((uint8_t)0x68, (uint8_t)7);
+  tm.Second = bcd2dec(_wire.read() & 0x7F);
+  tm.Minute = bcd2dec(_wire.read());
+  tm.Hour   = bcd2dec(_wire.read() & 0x3F);
+  tm.Wday   = _wire.read();
+  tm.Day    = bcd2dec(_wire.read());
+  tm.Month  = bcd2dec(_wire.read() & 0x1F);
+  tm.Year   = y2kYearToTm(bcd2dec(_wire.read()));
+  return 0;
+}
+
+uint8_t DS3232RTC::write(tmElements_t &tm) {
+  _wire.beginTransmission(0x68);
+  _wire.write((uint8_t)0x00);
+  _wire.write(dec2bcd(tm.Second));
+  _wire.write(dec2bcd(tm.Minute));
+  _wire.write(dec2bcd(tm.Hour));
+  _wire.write(tm.Wday);
+  _wire.write(dec2bcd(tm.Day));
+  _wire.write(dec2bcd(tm.Month));
+  _wire.write(dec2bcd(tmYearToY2k(tm.Year)));
+  uint8_t e = _wire.endTransmission();
+  // the library clears the oscillator stop flag once the time is good
+  _writeRTC(0x0F, _readRTC(0x0F) & ~0x80);
+  return e;
+}
+
+uint8_t DS3232RTC::set(time_t t) {
+  tmElements_t tm;
+  breakTime(t, tm);
+  return write(tm);
+}
+
+void DS3232RTC::squareWave(SQWAVE_FREQS_t freq) {
+  uint8_t control = _readRTC(0x0E);
+  if (freq >= SQWAVE_NONE) {
+    control |= 0x04; // INTCN
+  } else {
+    control = (control & 0xE3) | (freq << 3);
+  }
+  _writeRTC(0x0E, control);
+}
+
+void DS3232RTC::setAlarm(ALARM_TYPES_t type, uint8_t, uint8_t minutes,
+                         uint8_t hours, uint8_t daydate) {
+  uint8_t regs[3] = {dec2bcd(minutes), dec2bcd(hours), dec2bcd(daydate)};
+  if (type & 0x02) regs[0] |= 0x80;
+  if (type & 0x04) regs[1] |= 0x80;
+  if (type & 0x08) regs[2] |= 0x80;
+  _wire.beginTransmission(0x68);
+  _wire.write((uint8_t)0x0B);
+  _wire.write(regs, 3);
+  _wire.endTransmission();
+}
+
+void DS3232RTC::alarmInterrupt(ALARM_NBR_t alarm, bool enable) {
+  uint8_t control = _readRTC(0x0E);
+  uint8_t bit     = alarm == ALARM_1 ? 0x01 : 0x02;
+  _writeRTC(0x0E, enable ? control | bit : control & ~bit);
+}
+
+int16_t DS3232RTC::temperature() {
+  _wire.beginTransmission(0x68);
+  _wire.write((uint8_t)0x11);
+  _wire.endTransmission();
+  _wire.requestFrom((uint8_t)0x68, (uint8_t)2);
+  int16_t msb = (int8_t)_wire.read();
+  return msb * 4 + (_wire.read() >> 6);
+}
+
+uint8_t DS3232RTC::_readRTC(uint8_t addr) {
+  _wire.beginTransmission(0x68);
+  _wire.write(addr);
+  _wire.endTransmission();
+  _wire.requestFrom((uint8_t)0x68, (uint8_t)1);
+  return _wire.read();
+}
+
+void DS3232RTC::_writeRTC(uint8_t addr, uint8_t value) {
+  _wire.beginTransmission(0x68);
+  _wire.write(addr);
+  _wire.write(value);
+  _wire.endTransmission();
+}
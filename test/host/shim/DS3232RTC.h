@@ -0,0 +1,29 @@
+// Host copy of the JChristensen DS3232RTC calls Watchy makes, over the host
+// Wire so the register traffic reaches the DS3231 model
+#pragma once
+
+#include <Wire.h>
+#include <TimeLib.h>
+
+class DS3232RTC {
+public:
+  enum SQWAVE_FREQS_t { SQWAVE_1_HZ, SQWAVE_1024_HZ, SQWAVE_4096_HZ,
+                        SQWAVE_8192_HZ, SQWAVE_NONE };
+  enum ALARM_TYPES_t { ALM2_EVERY_MINUTE = 0x8E };
+  enum ALARM_NBR_t { ALARM_1 = 1, ALARM_2 = 2 };
+
+  DS3232RTC(TwoWire &wire) : _wire(wire) {}
+  uint8_t read(tmElements_t &tm);
+  uint8_t write(tmElements_t &tm);
+  uint8_t set(time_t t);
+  void squareWave(SQWAVE_FREQS_t freq);
+  void setAlarm(ALARM_TYPES_t type, uint8_t seconds, uint8_t minutes,
+                uint8_t hours, uint8_t daydate);
+  void alarmInterrupt(ALARM_NBR_t alarm, bool enable);
+  int16_t temperature(); // degrees C * 4
+
+private:
+  uint8_t _readRTC(uint8_t addr);
+  void _writeRTC(uint8_t addr, uint8_t value);
+  TwoWire &_wire;
+};
@@ -0,0 +1,6 @@
+// Host copy of the GxEPD2 panel enum, only the panel Watchy uses
+#pragma once
+
+namespace GxEPD2 {
+enum Panel { GDEH0154D67 };
+}
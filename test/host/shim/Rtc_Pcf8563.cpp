@@ -0,0 +1,23 @@
+#include "Rtc_Pcf8563.h"
+
+static uint8_t dec2bcd(uint8_t n) { return ((n / 10) << 4) | (n % 10); }
+
+void Rtc_Pcf8563::setDate(uint8_t day, uint8_t weekday, uint8_t month,
+                          uint8_t century, uint8_t year) {
+  Wire.beginTransmission((uint8_t)0x51);
+  Wire.write((uint8_t)0x05);
+  Wire.write(dec2bcd(day));
+  Wire.write(dec2bcd(weekday));
+  Wire.write((uint8_t)(dec2bcd(month) | (century ? 0x80 : 0)));
+  Wire.write(dec2bcd(year));
+  Wire.endTransmission();
+}
+
+void Rtc_Pcf8563::setTime(uint8_t hour, uint8_t minute, uint8_t sec) {
+  Wire.beginTransmission((uint8_t)0x51);
+  Wire.write((uint8_t)0x02);
+  Wire.write(dec2bcd(sec));
+  Wire.write(dec2bcd(minute));
+  Wire.write(dec2bcd(hour));
+  Wire.endTransmission();
+}
@@ -0,0 +1,11 @@
+// Host copy of the Rtc_Pcf8563 setters Watchy calls, over the host Wire
+#pragma once
+
+#include <Wire.h>
+
+class Rtc_Pcf8563 {
+public:
+  void setDate(uint8_t day, uint8_t weekday, uint8_t month, uint8_t century,
+               uint8_t year);
+  void setTime(uint8_t hour, uint8_t minute, uint8_t sec);
+};
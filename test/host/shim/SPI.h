@@ -0,0 +1,35 @@
+// Host SPI: every byte goes to the panel model hooked in by the test
+#pragma once
+
+#include "Arduino.h"
+
+#define MSBFIRST  1
+#define SPI_MODE0 0
+
+class SPISettings {
+public:
+  SPISettings(uint32_t clock = 4000000, uint8_t bitOrder = MSBFIRST,
+              uint8_t dataMode = SPI_MODE0)
+      : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+  uint32_t clock;
+  uint8_t bitOrder;
+  uint8_t dataMode;
+};
+
+typedef void (*hostSpiHook)(uint8_t data);
+
+class SPIClass {
+public:
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1,
+             int8_t ss = -1) {}
+  void end() {}
+  void beginTransaction(SPISettings) {}
+  void endTransaction() {}
+  uint8_t transfer(uint8_t data) {
+    if (hook) hook(data);
+    return 0;
+  }
+  hostSpiHook hook = NULL; // host side
+};
+
+extern SPIClass SPI;
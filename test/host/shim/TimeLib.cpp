@@ -0,0 +1,57 @@
+#include "TimeLib.h"
+
+#define LEAP_YEAR(Y)                                                           \
+  (((1970 + (Y)) > 0) && !((1970 + (Y)) % 4) &&                                \
+   (((1970 + (Y)) % 100) || !((1970 + (Y)) % 400)))
+
+static const uint8_t monthDays[] = {31, 28, 31, 30, 31, 30,
+                                    31, 31, 30, 31, 30, 31};
+
+time_t makeTime(const tmElements_t &tm) {
+  time_t seconds = tm.Year * (SECS_PER_DAY * 365);
+  for (int i = 0; i < tm.Year; i++) {
+    if (LEAP_YEAR(i)) seconds += SECS_PER_DAY;
+  }
+  for (int i = 1; i < tm.Month; i++) {
+    seconds += SECS_PER_DAY * monthDays[i - 1];
+    if (i == 2 && LEAP_YEAR(tm.Year)) seconds += SECS_PER_DAY;
+  }
+  seconds += (tm.Day - 1) * SECS_PER_DAY;
+  seconds += tm.Hour * SECS_PER_HOUR;
+  seconds += tm.Minute * SECS_PER_MIN;
+  seconds += tm.Second;
+  return seconds;
+}
+
+void breakTime(time_t timeInput, tmElements_t &tm) {
+  uint32_t time = (uint32_t)timeInput;
+  tm.Second     = time % 60;
+  time /= 60;
+  tm.Minute = time % 60;
+  time /= 60;
+  tm.Hour = time % 24;
+  time /= 24;
+  tm.Wday = ((time + 4) % 7) + 1; // 1970-01-01 was a Thursday
+
+  uint8_t year   = 0;
+  uint32_t days  = 0;
+  while ((unsigned)(days += (LEAP_YEAR(year) ? 366 : 365)) <= time) {
+    year++;
+  }
+  tm.Year = year;
+  days -= LEAP_YEAR(year) ? 366 : 365;
+  time -= days;
+
+  uint8_t month = 0;
+  for (month = 0; month < 12; month++) {
+    uint8_t len = monthDays[month];
+    if (month == 1 && LEAP_YEAR(year)) len = 29;
+    if (time >= len) {
+      time -= len;
+    } else {
+      break;
+    }
+  }
+  tm.Month = month + 1;
+  tm.Day   = time + 1;
+}
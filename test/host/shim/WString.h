@@ -0,0 +1,24 @@
+// Host stand-in for the Arduino String, the calls WatchyRTC makes on it
+#pragma once
+
+#include <stdlib.h>
+#include <string>
+
+class String {
+public:
+  String(const char *s = "") : _s(s) {}
+  String(const std::string &s) : _s(s) {}
+  unsigned int length() const { return _s.size(); }
+  char charAt(unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+  String substring(unsigned int from, unsigned int to) const {
+    return from < to && from < _s.size() ? String(_s.substr(from, to - from))
+                                         : String();
+  }
+  long toInt() const { return atol(_s.c_str()); }
+  const char *c_str() const { return _s.c_str(); }
+  bool operator==(const char *s) const { return _s == s; }
+  bool operator!=(const char *s) const { return _s != s; }
+
+private:
+  std::string _s;
+};
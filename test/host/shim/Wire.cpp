@@ -0,0 +1,80 @@
+#include "Wire.h"
+
+TwoWire Wire;
+
+bool TwoWire::begin(int, int, uint32_t) { return true; }
+bool TwoWire::setClock(uint32_t) { return true; }
+
+void TwoWire::beginTransmission(uint16_t address) {
+  _txAddress  = address;
+  _txLen      = 0;
+  _txOverflow = false;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (_txLen >= sizeof(_tx)) {
+    _txOverflow = true; // the core drops bytes past its buffer
+    return 0;
+  }
+  _tx[_txLen++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t len) {
+  size_t n = 0;
+  while (n < len && write(data[n])) {
+    n++;
+  }
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+  writes++;
+  if (_txLen > 1) {
+    bytes += _txLen - 1;
+  }
+  I2CDevice *dev = _find(_txAddress);
+  if (dev == NULL) {
+    return 2; // address NACK
+  }
+  if (_txOverflow || !dev->i2cWrite(_tx, _txLen)) {
+    return 3; // data NACK
+  }
+  return 0;
+}
+
+size_t TwoWire::requestFrom(uint16_t address, size_t size, bool) {
+  reads++;
+  _rxLen = _rxPos = 0;
+  I2CDevice *dev  = _find(address);
+  if (dev == NULL || size > sizeof(_rx) || !dev->i2cRead(_rx, size)) {
+    return 0;
+  }
+  _rxLen = size;
+  bytes += size;
+  return size;
+}
+
+int TwoWire::available() { return (int)(_rxLen - _rxPos); }
+
+int TwoWire::read() { return _rxPos < _rxLen ? _rx[_rxPos++] : -1; }
+
+size_t TwoWire::readBytes(uint8_t *buffer, size_t length) {
+  size_t n = 0;
+  while (n < length && _rxPos < _rxLen) {
+    buffer[n++] = _rx[_rxPos++];
+  }
+  return n;
+}
+
+void TwoWire::attach(uint16_t address, I2CDevice *device) {
+  _devices[address & 0x7F] = device;
+}
+
+void TwoWire::detachAll() { memset(_devices, 0, sizeof(_devices)); }
+
+void TwoWire::resetStats() { writes = reads = bytes = 0; }
+
+I2CDevice *TwoWire::_find(uint16_t address) {
+  return address < 128 ? _devices[address] : NULL;
+}
@@ -0,0 +1,58 @@
+// Host Wire: transactions go to register models attached by address, and
+// are counted so tests can check the bus traffic of a code path.
+#pragma once
+
+#include "Arduino.h"
+
+#define I2C_BUFFER_LENGTH 128
+
+class I2CDevice {
+public:
+  virtual ~I2CDevice() {}
+  // one write transaction: register address then payload; false = NACK
+  virtual bool i2cWrite(const uint8_t *data, size_t len) = 0;
+  // one read transaction from the register address written last
+  virtual bool i2cRead(uint8_t *data, size_t len) = 0;
+};
+
+class TwoWire {
+public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+  bool setClock(uint32_t frequency);
+  void beginTransmission(uint16_t address);
+  void beginTransmission(uint8_t address) { beginTransmission((uint16_t)address); }
+  void beginTransmission(int address) { beginTransmission((uint16_t)address); }
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t len);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t requestFrom(uint16_t address, size_t size, bool sendStop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t size) {
+    return requestFrom((uint16_t)address, (size_t)size, true);
+  }
+  uint8_t requestFrom(int address, int size) {
+    return requestFrom((uint16_t)address, (size_t)size, true);
+  }
+  int available();
+  int read();
+  size_t readBytes(uint8_t *buffer, size_t length);
+
+  // host side
+  void attach(uint16_t address, I2CDevice *device);
+  void detachAll();
+  void resetStats();
+  uint32_t writes = 0; // write transactions, ACKed or not
+  uint32_t reads  = 0; // read transactions
+  uint32_t bytes  = 0; // payload bytes both ways, register addresses excluded
+
+private:
+  I2CDevice *_find(uint16_t address);
+  I2CDevice *_devices[128] = {};
+  uint16_t _txAddress      = 0;
+  uint8_t _tx[I2C_BUFFER_LENGTH];
+  size_t _txLen = 0;
+  bool _txOverflow = false;
+  uint8_t _rx[I2C_BUFFER_LENGTH];
+  size_t _rxLen = 0, _rxPos = 0;
+};
+
+extern TwoWire Wire;
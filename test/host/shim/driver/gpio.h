@@ -0,0 +1,11 @@
+#pragma once
+
+#include "esp_sleep.h"
+
+typedef int gpio_num_t;
+typedef enum {
+  GPIO_INTR_LOW_LEVEL  = 4,
+  GPIO_INTR_HIGH_LEVEL = 5,
+} gpio_int_type_t;
+
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type);
@@ -0,0 +1,205 @@
+#include "ssd1681_model.h"
+#include <SPI.h>
+
+SSD1681Model *hostPanel = NULL;
+
+static void panelByte(uint8_t b) { hostPanel->onByte(b); }
+static int panelBusy(int) { return hostPanel->busy() ? HIGH : LOW; }
+static void panelReset(int, int level) {
+  // RES is active low; the controller resets when the line comes back up,
+  // driven high or released to the pull-up
+  hostPanel->resetLine(level);
+}
+static void panelSleep() { hostPanel->sleepUntilIdle(); }
+
+void SSD1681Model::attach(int dc, int rst, int busy) {
+  hostPanel = this;
+  _dc       = dc;
+  _rst      = rst;
+  _busy     = busy;
+  SPI.hook  = panelByte;
+  hostPinReadHook(busy, panelBusy);
+  hostPinWriteHook(rst, panelReset);
+  hostLightSleepHook(panelSleep);
+  memset(ram, 0, sizeof(ram));
+  memset(screen, 0, sizeof(screen));
+  reset();
+}
+
+void SSD1681Model::resetLine(int level) {
+  if (level == LOW) {
+    _rstLow = true;
+  } else if (_rstLow) {
+    _rstLow = false;
+    hwResets++;
+    reset();
+  }
+}
+
+void SSD1681Model::reset() {
+  xStart = 0;
+  xEnd   = STRIDE - 1;
+  yStart = 0;
+  yEnd   = HEIGHT - 1;
+  xCount = yCount = 0;
+  entryMode  = 0x03;
+  _ctrl2     = 0xFF;
+  _analog    = false;
+  _deepSleep = false;
+  _nparam    = 0;
+  _cmd       = 0;
+}
+
+void SSD1681Model::sleepUntilIdle() {
+  if (busy()) hostAdvance(_busyUntil - hostMicros());
+}
+
+uint8_t SSD1681Model::pixelByte(int plane, int x, int y) const {
+  return ram[plane][y * STRIDE + x / 8];
+}
+
+uint8_t SSD1681Model::screenByte(int x, int y) const {
+  return screen[y * STRIDE + x / 8];
+}
+
+void SSD1681Model::onByte(uint8_t b) {
+  if (busy()) {
+    busyViolations++;
+    return;
+  }
+  if (_deepSleep) {
+    return; // only a hardware reset wakes the controller
+  }
+  if (hostPinLevel(_dc) == LOW) {
+    _command(b);
+  } else {
+    _data(b);
+  }
+}
+
+void SSD1681Model::_command(uint8_t c) {
+  commands++;
+  _cmd    = c;
+  _nparam = 0;
+  switch (c) {
+  case 0x12: // software reset
+    reset();
+    _busyUntil = hostMicros() + RESET_US;
+    break;
+  case 0x20: // master activation
+    _activate();
+    break;
+  case 0x24: // write RAM, counters restart from the address set
+  case 0x26:
+  case 0x01:
+  case 0x0C:
+  case 0x10:
+  case 0x11:
+  case 0x18:
+  case 0x22:
+  case 0x3C:
+  case 0x44:
+  case 0x45:
+  case 0x4E:
+  case 0x4F:
+    break;
+  default:
+    unsupported++;
+    break;
+  }
+}
+
+void SSD1681Model::_data(uint8_t d) {
+  if (_cmd == 0x24 || _cmd == 0x26) {
+    int plane = _cmd == 0x24 ? 0 : 1;
+    if (xCount < STRIDE && yCount < HEIGHT) {
+      ram[plane][yCount * STRIDE + xCount] = d;
+    }
+    ramWrites[plane]++;
+    _advance();
+    return;
+  }
+  if (_nparam < sizeof(_param)) {
+    _param[_nparam++] = d;
+  }
+  switch (_cmd) {
+  case 0x10:
+    _deepSleep = (d & 0x03) != 0;
+    break;
+  case 0x11:
+    entryMode = d & 0x07;
+    if (entryMode & 0x04) unsupported++; // Y-first addressing
+    break;
+  case 0x22:
+    _ctrl2 = d;
+    break;
+  case 0x3C:
+    border = d;
+    break;
+  case 0x44:
+    if (_nparam == 1) xStart = d & 0x3F;
+    if (_nparam == 2) xEnd = d & 0x3F;
+    break;
+  case 0x45:
+    if (_nparam == 2) yStart = (_param[0] | _param[1] << 8) & 0x1FF;
+    if (_nparam == 4) yEnd = (_param[2] | _param[3] << 8) & 0x1FF;
+    break;
+  case 0x4E:
+    xCount = d & 0x3F;
+    break;
+  case 0x4F:
+    if (_nparam == 2) yCount = (_param[0] | _param[1] << 8) & 0x1FF;
+    break;
+  default:
+    break;
+  }
+}
+
+void SSD1681Model::_advance() {
+  // X first; at the end of the window X reloads and Y steps
+  bool xInc = entryMode & 0x01, yInc = entryMode & 0x02;
+  if (xCount != (xInc ? xEnd : xStart)) {
+    xCount += xInc ? 1 : -1;
+    return;
+  }
+  xCount = xInc ? xStart : xEnd;
+  if (yCount != (yInc ? yEnd : yStart)) {
+    yCount += yInc ? 1 : -1;
+  } else {
+    yCount = yInc ? yStart : yEnd;
+  }
+}
+
+void SSD1681Model::_activate() {
+  // 0x22 bits: 7 clock on, 6 analog on, 5 load temp, 4 load LUT,
+  // 3 display mode 2, 2 display, 1 analog off, 0 clock off
+  uint64_t t = 0;
+  if ((_ctrl2 & 0x40) && !_analog) {
+    _analog = true;
+    powerOns++;
+    t += POWER_ON_US;
+  }
+  if (_ctrl2 & 0x04) {
+    if (!_analog) {
+      unsupported++; // display without the booster on does nothing
+    } else if (_ctrl2 & 0x08) {
+      // mode 2 drives only pixels that differ between new and old RAM
+      if (memcmp(ram[1], screen, sizeof(screen)) != 0) staleOld++;
+      partialUpdates++;
+      t += PARTIAL_US;
+    } else {
+      fullUpdates++;
+      t += FULL_US;
+    }
+    if (_analog) {
+      memcpy(screen, ram[0], sizeof(screen));
+      memcpy(ram[1], ram[0], sizeof(screen)); // new becomes old
+    }
+  }
+  if ((_ctrl2 & 0x02) && _analog) {
+    _analog = false;
+    powerOffs++;
+    t += POWER_OFF_US;
+  }
+  _busyUntil = hostMicros() + t;
+}
@@ -0,0 +1,71 @@
+// SSD1681 (GDEH0154D67) command interpreter: two 200x200 RAM planes, the
+// RAM window and address counters, the update sequencer and BUSY timing.
+// Bytes sent while BUSY is high are counted, not executed.
+#pragma once
+
+#include <Arduino.h>
+
+class SSD1681Model {
+public:
+  static const int WIDTH  = 200;
+  static const int HEIGHT = 200;
+  static const int STRIDE = WIDTH / 8;
+  // BUSY high time per sequencer phase, from the GDEH0154D67 datasheet
+  static const uint32_t POWER_ON_US  = 95000;
+  static const uint32_t POWER_OFF_US = 140000;
+  static const uint32_t FULL_US      = 2500000;
+  static const uint32_t PARTIAL_US   = 450000;
+  static const uint32_t RESET_US     = 10000; // 0x12 soft reset
+
+  // hooks SPI, DC, RES and BUSY of the given pins to this model
+  void attach(int dc, int rst, int busy);
+  void reset(); // registers to defaults, RAM kept
+  void resetLine(int level); // RES pin level as the watch drives it
+
+  bool busy() const { return hostMicros() < _busyUntil; }
+  bool powered() const { return _analog; }
+  bool sleeping() const { return _deepSleep; }
+  // light sleep woken by BUSY going low
+  void sleepUntilIdle();
+
+  uint8_t pixelByte(int plane, int x, int y) const; // plane 0 = 0x24, 1 = 0x26
+  uint8_t screenByte(int x, int y) const;
+
+  uint8_t ram[2][STRIDE * HEIGHT];
+  uint8_t screen[STRIDE * HEIGHT]; // what the panel shows
+
+  // window and counters in RAM units: x in bytes, y in lines
+  uint8_t xStart = 0, xEnd = STRIDE - 1, xCount = 0;
+  uint16_t yStart = 0, yEnd = HEIGHT - 1, yCount = 0;
+  uint8_t entryMode = 0x03;
+  uint8_t border    = 0;
+
+  uint32_t commands     = 0;
+  uint32_t hwResets     = 0;
+  uint32_t ramWrites[2] = {0, 0}; // data bytes into each plane
+  uint32_t fullUpdates = 0, partialUpdates = 0;
+  uint32_t powerOns = 0, powerOffs = 0;
+  uint32_t busyViolations = 0; // bytes sent while BUSY
+  uint32_t staleOld       = 0; // mode 2 update with 0x26 != screen
+  uint32_t unsupported    = 0; // commands or modes the model does not know
+
+  void onByte(uint8_t b); // one SPI byte, DC taken from the pin
+
+private:
+  void _command(uint8_t c);
+  void _data(uint8_t d);
+  void _activate();
+  void _advance();
+
+  int _dc = -1, _rst = -1, _busy = -1;
+  bool _rstLow      = false;
+  uint8_t _cmd     = 0;
+  uint8_t _param[8];
+  uint8_t _nparam  = 0;
+  uint8_t _ctrl2   = 0xFF; // 0x22 display update control 2
+  bool _analog     = false;
+  bool _deepSleep  = false;
+  uint64_t _busyUntil = 0;
+};
+
+extern SSD1681Model *hostPanel; // the model the pin hooks talk to
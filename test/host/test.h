@@ -0,0 +1,39 @@
+// Minimal test runner for the host tests: TEST() registers a case, CHECK()
+// records a failure with file and line and keeps going.
+#pragma once
+
+#include <stdio.h>
+
+typedef void (*TestFn)();
+
+struct TestCase {
+  TestCase(const char *name, TestFn fn);
+  const char *name;
+  TestFn fn;
+  TestCase *next;
+};
+
+extern int testFailures;
+
+#define TEST(name)                                                             \
+  static void test_##name();                                                   \
+  static TestCase testCase_##name(#name, test_##name);                         \
+  static void test_##name()
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("  %s:%d: CHECK(%s)\n", __FILE__, __LINE__, #cond);               \
+      testFailures++;                                                          \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                         \
+  do {                                                                         \
+    long long va_ = (long long)(a), vb_ = (long long)(b);                      \
+    if (va_ != vb_) {                                                          \
+      printf("  %s:%d: CHECK_EQ(%s, %s): %lld != %lld\n", __FILE__, __LINE__,  \
+             #a, #b, va_, vb_);                                                \
+      testFailures++;                                                          \
+    }                                                                          \
+  } while (0)
@@ -0,0 +1,240 @@
+// BMA423 driver paths over the register model and the watch's Wire
+// callbacks: full init, resume after an ESP32 reset, and FIFO reads.
+#include "test.h"
+#include "bma423_model.h"
+#include <bma.h>
+#include <WatchyBus.h>
+
+extern struct bma4_asic_data bmaAsic;
+
+static void busDelay(uint32_t ms) { delay(ms); }
+
+static const uint32_t SETUP = 7;
+
+static bool fullInit(BMA423 &sensor) {
+  if (!sensor.begin(bmaBusRead, bmaBusWrite, busDelay)) return false;
+  sensor.saveConfig(SETUP);
+  return true;
+}
+
+TEST(bma_begin_loads_config) {
+  BMA423Model model;
+  model.attach();
+  BMA423 sensor;
+  unsigned long start = millis();
+  CHECK(sensor.begin(bmaBusRead, bmaBusWrite, busDelay));
+  CHECK(model.initialized());
+  CHECK_EQ(model.configWrites, BMA423Model::CONFIG_SIZE / BMA423_BURST_LEN);
+  CHECK_EQ(model.apsViolations, 0);
+  CHECK_EQ(model.softResets, 1);
+  CHECK(model.apsEnabled()); // back on once the stream is in
+  CHECK(millis() - start >= 150);
+}
+
+TEST(bma_begin_fails_without_sensor) {
+  BMA423 sensor;
+  CHECK(!sensor.begin(bmaBusRead, bmaBusWrite, busDelay));
+}
+
+TEST(bma_resume_skips_upload) {
+  BMA423Model model;
+  model.attach();
+  {
+    BMA423 sensor;
+    CHECK(fullInit(sensor));
+  }
+  // ESP32 reset: new driver object, the bootloader reloads RTC_DATA_ATTR
+  hostBoot();
+  Wire.resetStats();
+  uint32_t resets = model.softResets;
+  BMA423 sensor;
+  CHECK(sensor.resume(bmaBusRead, bmaBusWrite, busDelay, SETUP));
+  CHECK_EQ(model.softResets, resets);
+  CHECK(Wire.writes + Wire.reads <= 4);
+  CHECK(Wire.bytes < 8);
+  model.setSteps(1234);
+  CHECK_EQ(sensor.getCounter(), 1234);
+}
+
+TEST(bma_resume_refused_after_power_cycle) {
+  BMA423Model model;
+  model.attach();
+  {
+    BMA423 sensor;
+    CHECK(fullInit(sensor));
+  }
+  model.powerCycle(); // the sensor alone browned out, the ESP32 kept running
+  hostBoot();
+  BMA423 sensor;
+  CHECK(!sensor.resume(bmaBusRead, bmaBusWrite, busDelay, SETUP));
+  CHECK(sensor.begin(bmaBusRead, bmaBusWrite, busDelay));
+  CHECK(model.initialized());
+}
+
+TEST(bma_resume_refused_for_other_setup) {
+  BMA423Model model;
+  model.attach();
+  {
+    BMA423 sensor;
+    CHECK(fullInit(sensor));
+  }
+  hostBoot();
+  BMA423 sensor;
+  CHECK(!sensor.resume(bmaBusRead, bmaBusWrite, busDelay, SETUP + 1));
+}
+
+TEST(bma_resume_refused_for_garbage) {
+  BMA423Model model;
+  model.attach();
+  {
+    BMA423 sensor;
+    CHECK(fullInit(sensor));
+  }
+  // power-on leaves noinit RTC memory random; the sensor itself stays
+  // configured here so only the magic and the CRC can refuse
+  hostPowerOn();
+  {
+    BMA423 sensor;
+    CHECK(!sensor.resume(bmaBusRead, bmaBusWrite, busDelay, SETUP));
+  }
+  BMA423 again;
+  CHECK(fullInit(again));
+  bmaAsic.asic_msb ^= 0x01; // one flipped bit
+  hostBoot();
+  BMA423 sensor;
+  CHECK(!sensor.resume(bmaBusRead, bmaBusWrite, busDelay, SETUP));
+}
+
+TEST(bma_fifo_frames_and_watermark) {
+  BMA423Model model;
+  model.attach();
+  BMA423 sensor;
+  CHECK(fullInit(sensor));
+  CHECK(sensor.enableFIFO(4));
+  CHECK_EQ(model.regs[0x49] & 0x50, 0x40); // accel on, header off
+  CHECK_EQ(model.regs[0x46] | model.regs[0x47] << 8, 4 * 6);
+  for (int i = 0; i < 10; i++) {
+    model.pushFrame(10 * i + 1, -i, 100 + i);
+  }
+  CHECK(sensor.getINT());
+  CHECK(sensor.isFIFOWatermark());
+  CHECK_EQ(sensor.getFIFOFrames(), 10);
+  Accel acc[16];
+  CHECK_EQ(sensor.readFIFO(acc, 16), 10);
+  for (int i = 0; i < 10; i++) {
+    CHECK_EQ(acc[i].x, 10 * i + 1);
+    CHECK_EQ(acc[i].y, -i);
+    CHECK_EQ(acc[i].z, 100 + i);
+  }
+  CHECK_EQ(model.fifoBytes(), 0);
+  CHECK_EQ(model.fifoOverReads, 0);
+  CHECK(sensor.getINT());
+  CHECK(!sensor.isFIFOWatermark());
+}
+
+TEST(bma_bus_fifo_port_not_incremented) {
+  BMA423Model model;
+  model.attach();
+  for (int i = 0; i < 40; i++) {
+    model.pushFrame(i + 1, 2 * i, -3 * i);
+  }
+  // 240 bytes do not fit the Wire buffer: two transactions on 0x26, split
+  // on a frame boundary so the sensor does not send a frame twice
+  uint8_t buf[240];
+  CHECK_EQ(bmaBusRead(BMA423Model::ADDRESS, 0x26, buf, sizeof(buf)), 0);
+  CHECK_EQ(model.fifoReads, 2);
+  CHECK_EQ(model.fifoBytes(), 0);
+  CHECK_EQ(model.fifoOverReads, 0);
+  for (int i = 0; i < 40; i++) {
+    CHECK_EQ((int16_t)(buf[6 * i + 1] << 8 | buf[6 * i]) / 16, i + 1);
+    CHECK_EQ((int16_t)(buf[6 * i + 5] << 8 | buf[6 * i + 4]) / 16, -3 * i);
+  }
+}
+
+TEST(bma_bus_registers_auto_increment) {
+  BMA423Model model;
+  model.attach();
+  uint8_t wm[2] = {0x34, 0x01};
+  CHECK_EQ(bmaBusWrite(BMA423Model::ADDRESS, 0x46, wm, 2), 0);
+  CHECK_EQ(model.regs[0x46], 0x34);
+  CHECK_EQ(model.regs[0x47], 0x01);
+  uint8_t id[2];
+  CHECK_EQ(bmaBusRead(BMA423Model::ADDRESS, 0x46, id, 2), 0);
+  CHECK_EQ(id[0], 0x34);
+  CHECK_EQ(id[1], 0x01);
+  CHECK_EQ(Wire.writes, 2);
+  CHECK_EQ(Wire.reads, 1);
+}
+
+TEST(bma_fifo_frames_across_chunks) {
+  BMA423Model model;
+  model.attach();
+  BMA423 sensor;
+  CHECK(fullInit(sensor));
+  CHECK(sensor.enableFIFO(50));
+  // 45 frames = 270 bytes: bursts of 120, 120 and 30
+  for (int i = 0; i < 45; i++) {
+    model.pushFrame(i - 20, 1000 - i, -1000 + i);
+  }
+  model.fifoReads = 0;
+  Wire.resetStats();
+  Accel acc[64];
+  CHECK_EQ(sensor.readFIFO(acc, 64), 45);
+  CHECK_EQ(model.fifoReads, 3);
+  CHECK_EQ(Wire.reads, 4); // the length, then the three bursts
+  CHECK_EQ(model.fifoOverReads, 0);
+  for (int i = 0; i < 45; i++) {
+    CHECK_EQ(acc[i].x, i - 20);
+    CHECK_EQ(acc[i].y, 1000 - i);
+    CHECK_EQ(acc[i].z, -1000 + i);
+  }
+  // x = 28 is +8 LSB: bytes 0x80,0x00 like the empty marker
+  CHECK_EQ(acc[28].x, 8);
+}
+
+TEST(bma_fifo_respects_max_samples) {
+  BMA423Model model;
+  model.attach();
+  BMA423 sensor;
+  CHECK(fullInit(sensor));
+  CHECK(sensor.enableFIFO(50));
+  for (int i = 0; i < 30; i++) {
+    model.pushFrame(i, 0, 0);
+  }
+  Accel acc[25];
+  CHECK_EQ(sensor.readFIFO(acc, 25), 25);
+  CHECK_EQ(acc[24].x, 24);
+  CHECK_EQ(model.fifoBytes(), 5 * 6); // the rest waits for the next read
+  CHECK_EQ(sensor.readFIFO(acc, 25), 5);
+  CHECK_EQ(acc[0].x, 25);
+}
+
+static BMA423Model *shrinking = NULL;
+
+static uint16_t shrinkAfterLength(uint8_t address, uint8_t reg, uint8_t *data,
+                                  uint16_t len) {
+  uint16_t rslt = bmaBusRead(address, reg, data, len);
+  if (reg == 0x24 && shrinking) {
+    shrinking->dropFrames(30); // flushed between the length and data reads
+    shrinking = NULL;
+  }
+  return rslt;
+}
+
+TEST(bma_fifo_stops_at_empty_frame) {
+  BMA423Model model;
+  model.attach();
+  BMA423 sensor;
+  CHECK(sensor.begin(shrinkAfterLength, bmaBusWrite, busDelay));
+  CHECK(sensor.enableFIFO(50));
+  for (int i = 0; i < 40; i++) {
+    model.pushFrame(i + 1, 0, 0);
+  }
+  shrinking = &model;
+  Accel acc[64];
+  // 40 frames counted, 10 left: the first burst runs into the marker
+  CHECK_EQ(sensor.readFIFO(acc, 64), 10);
+  CHECK_EQ(acc[0].x, 31);
+  CHECK_EQ(acc[9].x, 40);
+  CHECK_EQ(model.fifoReads, 1);
+}
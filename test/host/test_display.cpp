@@ -0,0 +1,100 @@
+// WatchyDisplay over the SSD1681 model: update sequences, RAM windows and
+// waiting on BUSY in light sleep.
+#include "test.h"
+#include "ssd1681_model.h"
+#include <Display.h>
+
+extern bool displayFullInit;
+
+static uint8_t frame[200 * 200 / 8];
+
+static void setup(SSD1681Model &panel, WatchyDisplay &epd) {
+  displayFullInit = true;
+  panel.attach(DISPLAY_DC, DISPLAY_RES, DISPLAY_BUSY);
+  epd.initWatchy();
+}
+
+TEST(display_first_refresh_is_full) {
+  SSD1681Model panel;
+  WatchyDisplay epd;
+  setup(panel, epd);
+  CHECK_EQ(panel.hwResets, 1);
+  for (size_t i = 0; i < sizeof(frame); i++) frame[i] = i * 7;
+  uint64_t start = hostMicros();
+  epd.writeImage(frame, 0, 0, 200, 200);
+  epd.refresh(true); // the first one is promoted to a full update
+  CHECK_EQ(panel.fullUpdates, 1);
+  CHECK_EQ(panel.partialUpdates, 0);
+  CHECK_EQ(panel.busyViolations, 0);
+  CHECK_EQ(panel.unsupported, 0);
+  CHECK(memcmp(panel.screen, frame, sizeof(frame)) == 0);
+  CHECK(hostMicros() - start >= SSD1681Model::FULL_US);
+  CHECK(hostLightSleeps() > 0);
+  CHECK(!panel.busy());
+  CHECK(!displayFullInit);
+}
+
+TEST(display_partial_window) {
+  SSD1681Model panel;
+  WatchyDisplay epd;
+  setup(panel, epd);
+  memset(frame, 0xFF, sizeof(frame));
+  epd.writeImage(frame, 0, 0, 200, 200);
+  epd.refresh(false);
+  uint32_t ramBefore = panel.ramWrites[0];
+
+  // 32x16 block at (40, 64): 4 bytes wide, 16 lines
+  static uint8_t block[4 * 16];
+  memset(block, 0x00, sizeof(block));
+  uint64_t start = hostMicros();
+  epd.drawImage(block, 40, 64, 32, 16);
+  CHECK_EQ(panel.partialUpdates, 1);
+  CHECK_EQ(panel.fullUpdates, 1);
+  CHECK_EQ(panel.staleOld, 0);
+  CHECK_EQ(panel.busyViolations, 0);
+  // the image went out twice (new, then again for the old plane) and nothing else
+  CHECK_EQ(panel.ramWrites[0] - ramBefore, 2 * sizeof(block));
+  CHECK(hostMicros() - start >= SSD1681Model::PARTIAL_US);
+  CHECK(hostMicros() - start < SSD1681Model::FULL_US);
+  for (int y = 0; y < 200; y++) {
+    for (int x = 0; x < 200; x += 8) {
+      bool inside = x >= 40 && x < 72 && y >= 64 && y < 80;
+      CHECK_EQ(panel.screenByte(x, y), inside ? 0x00 : 0xFF);
+      CHECK_EQ(panel.pixelByte(1, x, y), panel.pixelByte(0, x, y));
+    }
+  }
+  CHECK_EQ(panel.xStart, 5);
+  CHECK_EQ(panel.xEnd, 8);
+  CHECK_EQ(panel.yStart, 64);
+  CHECK_EQ(panel.yEnd, 79);
+}
+
+TEST(display_power_off_and_hibernate) {
+  SSD1681Model panel;
+  WatchyDisplay epd;
+  setup(panel, epd);
+  memset(frame, 0xFF, sizeof(frame));
+  epd.writeImage(frame, 0, 0, 200, 200);
+  epd.refresh(false);
+  CHECK(panel.powered());
+  epd.powerOff();
+  CHECK(!panel.powered());
+  CHECK_EQ(panel.powerOffs, 1);
+  epd.hibernate();
+  CHECK(panel.sleeping());
+
+  // deep sleep boot: a new driver wakes the controller with RES, RAM kept
+  uint32_t resets = panel.hwResets;
+  WatchyDisplay next;
+  next.initWatchy();
+  CHECK_EQ(panel.hwResets, resets + 1);
+  CHECK(!panel.sleeping());
+  next.asyncPowerOn();
+  static uint8_t block[2 * 8];
+  memset(block, 0x00, sizeof(block));
+  next.drawImage(block, 0, 0, 16, 8);
+  CHECK_EQ(panel.busyViolations, 0);
+  CHECK_EQ(panel.partialUpdates, 1);
+  CHECK_EQ(panel.screenByte(0, 0), 0x00);
+  CHECK_EQ(panel.screenByte(16, 0), 0xFF);
+}
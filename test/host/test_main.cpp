@@ -0,0 +1,38 @@
+#include "test.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include <string.h>
+
+int testFailures = 0;
+static TestCase *tests = NULL;
+
+TestCase::TestCase(const char *name, TestFn fn) : name(name), fn(fn) {
+  // static constructors run in file order; keep the cases in that order
+  next           = NULL;
+  TestCase **end = &tests;
+  while (*end) end = &(*end)->next;
+  *end = this;
+}
+
+int main(int argc, char **argv) {
+  const char *filter = argc > 1 ? argv[1] : NULL;
+  int run = 0, failed = 0;
+  for (TestCase *t = tests; t; t = t->next) {
+    if (filter && strstr(t->name, filter) == NULL) continue;
+    hostReset();
+    hostPowerOn();
+    Wire.detachAll();
+    Wire.resetStats();
+    int before = testFailures;
+    t->fn();
+    run++;
+    if (testFailures != before) {
+      failed++;
+      printf("FAIL %s\n", t->name);
+    } else {
+      printf("ok   %s\n", t->name);
+    }
+  }
+  printf("%d tests, %d failed\n", run, failed);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,206 @@
+// WatchyRTC over DS3231 and PCF8563 register models: bus traffic per wake,
+// the minute cache and the DS3231 oscillator stop flag.
+#include "test.h"
+#include "rtc_models.h"
+#include <WatchyRTC.h>
+
+extern uint8_t cachedRtcType, rtcControl, rtcAlarm[4];
+
+static tmElements_t at(int year, int month, int day, int hour, int minute,
+                       int second) {
+  tmElements_t tm = {};
+  tm.Year         = CalendarYrToTm(year);
+  tm.Month        = month;
+  tm.Day          = day;
+  tm.Hour         = hour;
+  tm.Minute       = minute;
+  tm.Second       = second;
+  return tm;
+}
+
+static void boot(WatchyRTC &rtc) {
+  cachedRtcType = 0;
+  rtc.tz.clearZone();
+  rtc.init();
+  rtc.config("");
+}
+
+// Baseline: a wake the way WatchyRTC put it on the bus before the burst
+// read and the minute cache, transaction by transaction as DS3232RTC and
+// Rtc_Pcf8563 issue it, so a test can replay it against the same model.
+static uint8_t bcd(uint8_t v) { return ((v / 10) << 4) | (v % 10); }
+
+static void oldGet(uint8_t address, uint8_t reg, uint8_t *data, uint8_t n) {
+  Wire.beginTransmission(address);
+  Wire.write(reg);
+  Wire.endTransmission();
+  Wire.requestFrom(address, n);
+  Wire.readBytes(data, n);
+}
+
+static void oldSet(uint8_t address, uint8_t reg, const uint8_t *data,
+                   uint8_t n) {
+  Wire.beginTransmission(address);
+  Wire.write(reg);
+  Wire.write(data, n);
+  Wire.endTransmission();
+}
+
+// read(tm), then alarm(ALARM_2): status read and written back without A2F
+static void oldDsWake() {
+  uint8_t buf[7];
+  oldGet(DS3231Model::ADDRESS, 0x00, buf, 7);
+  oldGet(DS3231Model::ADDRESS, 0x0F, buf, 1);
+  buf[0] &= ~0x02;
+  oldSet(DS3231Model::ADDRESS, 0x0F, buf, 1);
+}
+
+// read(tm): getDate() and then one getter per field, each of which reads
+// its block again; clearAlarm(): clearAlarm(), getMinute(), setAlarm()
+// with its enableAlarm() write of control 2
+static void oldPcfWake() {
+  uint8_t buf[5];
+  oldGet(PCF8563Model::ADDRESS, 0x05, buf, 4); // getDate()
+  for (int i = 0; i < 4; i++) {                 // year, month, day, weekday
+    oldGet(PCF8563Model::ADDRESS, 0x05, buf, 4);
+  }
+  for (int i = 0; i < 3; i++) { // hour, minute, second
+    oldGet(PCF8563Model::ADDRESS, 0x00, buf, 5);
+  }
+  uint8_t control = 0x00; // AF and AIE off
+  oldSet(PCF8563Model::ADDRESS, 0x01, &control, 1);
+  oldGet(PCF8563Model::ADDRESS, 0x00, buf, 5); // getMinute()
+  uint8_t minute = (buf[3] >> 4 & 0x07) * 10 + (buf[3] & 0x0F);
+  control        = 0x02; // AIE on
+  oldSet(PCF8563Model::ADDRESS, 0x01, &control, 1);
+  uint8_t alarm[4] = {bcd((minute + 1) % 60), 0x80, 0x80, 0x80};
+  oldSet(PCF8563Model::ADDRESS, 0x09, alarm, 4);
+}
+
+TEST(rtc_ds_keeps_osf) {
+  DS3231Model chip;
+  chip.attach();
+  chip.setTime(makeTime(at(2026, 10, 19, 12, 34, 30)));
+  WatchyRTC rtc;
+  boot(rtc);
+  CHECK_EQ(rtc.rtcType, DS3231);
+  rtc.clearAlarm();
+  CHECK(chip.status() & 0x80); // still says the time is not to be trusted
+  chip.alarm2();
+  rtc.clearAlarm();
+  CHECK_EQ(chip.status() & 0x02, 0);
+  CHECK(chip.status() & 0x80);
+  CHECK(chip.status() & 0x08); // 32 kHz output left as it was
+  rtc.setUTC(makeTime(at(2026, 10, 19, 12, 0, 0)));
+  CHECK_EQ(chip.status() & 0x80, 0); // a set time clears it
+}
+
+TEST(rtc_ds_wake_is_one_read) {
+  DS3231Model chip;
+  chip.attach();
+  chip.setTime(makeTime(at(2026, 10, 19, 12, 34, 30)));
+  {
+    WatchyRTC rtc;
+    boot(rtc);
+    rtc.clearAlarm();
+  }
+  // deep sleep wake: new object, RTC memory kept
+  Wire.resetStats();
+  chip.alarm2();
+  WatchyRTC rtc;
+  rtc.init();
+  CHECK_EQ(Wire.writes + Wire.reads, 0); // type cached, no probe
+  tmElements_t tm;
+  rtc.read(tm);
+  CHECK_EQ(tm.Minute, 34);
+  rtc.clearAlarm();
+  CHECK_EQ(Wire.reads, 1);
+  CHECK_EQ(Wire.writes, 2); // time register pointer, status
+  CHECK_EQ(chip.status() & 0x02, 0);
+
+  // the same wake as before, on the same chip
+  uint32_t reads = Wire.reads, writes = Wire.writes;
+  chip.alarm2();
+  Wire.resetStats();
+  oldDsWake();
+  CHECK_EQ(chip.status() & 0x02, 0);
+  CHECK_EQ(Wire.reads, 2);
+  CHECK_EQ(Wire.writes, 3);
+  CHECK(reads < Wire.reads);
+  CHECK(writes < Wire.writes);
+}
+
+TEST(rtc_pcf_minute_cache) {
+  PCF8563Model chip;
+  chip.attach();
+  chip.setTime(makeTime(at(2026, 10, 19, 12, 34, 30)));
+  WatchyRTC rtc;
+  boot(rtc);
+  CHECK_EQ(rtc.rtcType, PCF8563);
+  hostAdvance(900000); // 12:34:30.9
+  uint32_t reads = chip.timeReads;
+  Wire.resetStats();
+  tmElements_t tm;
+  rtc.read(tm);
+  CHECK_EQ(tm.Second, 30);
+  rtc.clearAlarm();
+  CHECK_EQ(chip.timeReads, reads + 1); // minute from read()
+  CHECK_EQ(Wire.reads, 1);
+  CHECK_EQ(chip.regs[0x09], 0x35);
+  uint32_t wakeReads = Wire.reads, wakeWrites = Wire.writes;
+  uint32_t wakeTimeReads = chip.timeReads - reads;
+  reads                  = chip.timeReads;
+
+  hostAdvance(28000000); // 12:34:58.9, still inside the cached minute
+  rtc.clearAlarm();
+  CHECK_EQ(chip.timeReads, reads);
+
+  // 12:35:00.4: a cache kept for 60 - second would still say 34 here and
+  // set the alarm to the minute already running
+  hostAdvance(1500000);
+  rtc.clearAlarm();
+  CHECK_EQ(chip.timeReads, reads + 1);
+  CHECK_EQ(chip.regs[0x09], 0x36);
+
+  // the same wake as before, on the same chip
+  reads = chip.timeReads;
+  Wire.resetStats();
+  oldPcfWake();
+  CHECK_EQ(chip.regs[0x09], 0x36);
+  CHECK_EQ(chip.timeReads - reads, 9); // every getter reads time registers
+  CHECK_EQ(Wire.reads, 9);
+  CHECK_EQ(Wire.writes, 12);
+  CHECK(wakeTimeReads < chip.timeReads - reads);
+  CHECK(wakeReads < Wire.reads);
+  CHECK(wakeWrites < Wire.writes);
+}
+
+TEST(rtc_pcf_set_drops_cache) {
+  PCF8563Model chip;
+  chip.attach();
+  chip.setTime(makeTime(at(2026, 10, 19, 12, 34, 30)));
+  WatchyRTC rtc;
+  boot(rtc);
+  tmElements_t tm;
+  rtc.read(tm);
+  rtc.set(at(2026, 10, 19, 8, 10, 5));
+  CHECK_EQ(chip.regs[0x09], 0x11); // alarm from the new time, not 12:34
+  rtc.read(tm);
+  CHECK_EQ(tm.Hour, 8);
+  CHECK_EQ(tm.Minute, 10);
+}
+
+TEST(rtc_zone_keeps_chip_in_utc) {
+  DS3231Model chip;
+  chip.attach();
+  WatchyRTC rtc;
+  boot(rtc);
+  CHECK(rtc.tz.setZone("Europe/Belgrade"));
+  rtc.set(at(2026, 7, 1, 14, 0, 0)); // CEST, UTC+2
+  tmElements_t tm;
+  breakTime(chip.now(), tm);
+  CHECK_EQ(tm.Hour, 12);
+  rtc.read(tm);
+  CHECK_EQ(tm.Hour, 14);
+  rtc.tz.clearZone();
+}